@@ -0,0 +1,393 @@
+// Benchmark suite for the emulator. Built with `make bench`; prints one JSON
+// document to stdout so results can be diffed or tracked over time.
+//
+//   csopesy-bench [--filter <substring>] [--quick]
+//
+// Micro benchmarks time batches of operations and report per-operation
+// percentiles over the batches. Macro benchmarks run a fixed seeded workload
+// in deterministic mode and sample wall time per window of CPU ticks. Every
+// result also reports heap allocations per operation, from all threads.
+#include "../src/CPUScheduler.h"
+#include "../src/Config.h"
+#include "../src/MemoryManager.h"
+#include "../src/Process.h"
+#include "../src/ProcessPool.h"
+#include "../src/ProgramCache.h"
+#include "../src/ProgramParser.h"
+#include "../src/Random.h"
+#include "../src/Workload.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+using BenchClock = std::chrono::steady_clock;
+
+// Counts every heap allocation in the process
+static std::atomic<uint64_t> allocationCount{0};
+
+void* operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* pointer = std::malloc(size ? size : 1)) return pointer;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t align) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    std::size_t alignment = static_cast<std::size_t>(align);
+    if (void* pointer = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment)) return pointer;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept { std::free(pointer); }
+
+namespace {
+
+struct Result {
+    std::string name;
+    uint64_t ops = 0;
+    double seconds = 0.0;
+    uint64_t allocations = 0;
+    std::vector<double> samples; // nanoseconds per op, one per batch/window
+};
+
+struct Options {
+    std::string filter;
+    bool quick = false;
+};
+
+double percentile(std::vector<double> values, double p) {
+    if (values.empty()) return 0.0;
+    size_t index = static_cast<size_t>(p * (values.size() - 1) + 0.5);
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+double secondsSince(BenchClock::time_point start) {
+    return std::chrono::duration<double>(BenchClock::now() - start).count();
+}
+
+// Runs op(i) for batches * batchSize iterations, timing each batch
+template <typename Op>
+Result runBatched(const std::string& name, size_t batches, size_t batchSize, Op&& op) {
+    Result result;
+    result.name = name;
+    result.samples.reserve(batches);
+
+    auto start = BenchClock::now();
+    uint64_t allocationsBefore = allocationCount;
+    uint64_t i = 0;
+    for (size_t b = 0; b < batches; ++b) {
+        auto batchStart = BenchClock::now();
+        for (size_t k = 0; k < batchSize; ++k) {
+            op(i++);
+        }
+        result.samples.push_back(secondsSince(batchStart) * 1e9 / batchSize);
+    }
+    result.seconds = secondsSince(start);
+    result.allocations = allocationCount - allocationsBefore;
+    result.ops = i;
+    return result;
+}
+
+// Keeps the emulator's own console output out of the JSON
+class QuietCout {
+public:
+    QuietCout() : saved(std::cout.rdbuf(sink.rdbuf())) {}
+    ~QuietCout() { std::cout.rdbuf(saved); }
+
+private:
+    std::ostringstream sink;
+    std::streambuf* saved;
+};
+
+Result benchInterpreter(const Options& opts, bool optimize) {
+    Config config; // defaults: 1000-2000 instructions per process
+    if (optimize) {
+        QuietCout quiet;
+        std::ofstream("optimize.txt") << "optimize 1\n";
+        config.loadFromFile("optimize.txt");
+    }
+    WorkloadGenerator workload;
+    workload.configure(config, 42);
+
+    const size_t batches = opts.quick ? 200 : 2000;
+    const size_t batchSize = 1000;
+
+    // Build every process up front so the timed loop only interprets
+    std::vector<ProcessPtr> processes;
+    uint64_t planned = 0;
+    for (int pid = 1; planned < batches * batchSize; ++pid) {
+        processes.push_back(workload.build("p" + std::to_string(pid), pid));
+        planned += processes.back()->totalInstructions;
+    }
+
+    size_t current = 0;
+    return runBatched(optimize ? "interpreter/execute-optimized" : "interpreter/execute", batches, batchSize, [&](uint64_t) {
+        if (!processes[current]->executeNextInstruction(0) && current + 1 < processes.size()) {
+            current++;
+        }
+    });
+}
+
+Result benchAllocator(const Options& opts) {
+    FirstFitMemoryAllocator allocator;
+    allocator.init(16384, 64, 4096);
+
+    std::vector<ProcessPtr> processes;
+    for (int pid = 1; pid <= 4; ++pid) {
+        processes.push_back(std::make_shared<Process>("p" + std::to_string(pid), pid, 4096));
+    }
+
+    const size_t batches = opts.quick ? 50 : 500;
+    return runBatched("allocator/allocate+deallocate", batches, 16, [&](uint64_t i) {
+        const ProcessPtr& process = processes[i % processes.size()];
+        allocator.allocate(process);
+        allocator.deallocate(process);
+    });
+}
+
+// Creating and dropping a process with the largest address space
+Result benchProcessCreate(const Options& opts) {
+    const size_t batches = opts.quick ? 200 : 2000;
+    return runBatched("process/create-64k", batches, 100, [](uint64_t i) {
+        ProcessPtr process = ProcessPool::make("p", static_cast<int>(i), 65536);
+        process->writeToMemory(0x100, static_cast<uint16_t>(i));
+    });
+}
+
+// Whole life of a generated process: build, run to the end, drop
+Result benchProcessLifecycle(const Options& opts) {
+    Config config; // defaults: 1000-2000 instructions per process
+    WorkloadGenerator workload;
+    workload.configure(config, 42);
+
+    const size_t batches = opts.quick ? 20 : 200;
+    return runBatched("process/generate-run-drop", batches, 10, [&](uint64_t i) {
+        ProcessPtr process = workload.build("p" + std::to_string(i), static_cast<int>(i) + 1);
+        while (process->executeNextInstruction(0)) {
+        }
+    });
+}
+
+Result benchPageTableHit(const Options& opts) {
+    FirstFitMemoryAllocator allocator;
+    allocator.init(16384, 64, 4096);
+    for (int pid = 1; pid <= 4; ++pid) {
+        allocator.allocate(std::make_shared<Process>("p" + std::to_string(pid), pid, 4096));
+    }
+
+    Xoshiro256 rng(7);
+    std::string err;
+    const size_t batches = opts.quick ? 200 : 2000;
+    return runBatched("pagetable/lookup-hit", batches, 1000, [&](uint64_t) {
+        int pid = static_cast<int>(rng.range(1, 4));
+        int page = static_cast<int>(rng.range(0, 63));
+        allocator.ensurePageMapped(pid, page, err);
+    });
+}
+
+Result benchPageTableFault(const Options& opts) {
+    // Five processes sweeping 64 pages each over 256 frames: FIFO misses every time
+    FirstFitMemoryAllocator allocator;
+    allocator.init(16384, 64, 4096);
+
+    std::string err;
+    const size_t batches = opts.quick ? 20 : 200;
+    return runBatched("pagetable/fault-evict", batches, 100, [&](uint64_t i) {
+        int pid = static_cast<int>((i / 64) % 5) + 1;
+        int page = static_cast<int>(i % 64);
+        allocator.ensurePageMapped(pid, page, err);
+    });
+}
+
+// A screen -c style program of about `statements` statements: straight-line
+// arithmetic and memory traffic with FOR blocks nested three deep
+std::string sampleProgram(int statements) {
+    std::string source;
+    int written = 0;
+    for (int block = 0; written < statements; ++block) {
+        std::string n = std::to_string(block);
+        source += "DECLARE x" + n + " " + n + "; ADD y x" + n + " 7; WRITE 0x" + std::to_string(40 + block % 20) +
+                  " y; READ z 0x40; PRINT(\\\"Value: \\\" + z); ";
+        source += "FOR([SUBTRACT y y 1; FOR([FOR([ADD w w y], 2); SLEEP 1], 3)], 4); ";
+        written += 10;
+    }
+    return source;
+}
+
+Result benchParser(const Options& opts, int statements) {
+    const std::string source = sampleProgram(statements);
+    ParsedProgram program;
+    ParseError error;
+
+    const size_t batches = opts.quick ? 50 : 500;
+    const size_t batchSize = statements >= 1000 ? 10 : 1000;
+    return runBatched("parser/statements-" + std::to_string(statements), batches, batchSize, [&](uint64_t) {
+        parseProgram(source, program, error);
+    });
+}
+
+// Resubmitting one of a few hot screen -c programs: a hash lookup instead of a parse
+Result benchProgramCache(const Options& opts) {
+    std::vector<std::string> sources;
+    for (int i = 0; i < 16; ++i) {
+        sources.push_back(sampleProgram(40) + "DECLARE tag " + std::to_string(i));
+    }
+    ProgramCache cache;
+    cache.reset(256);
+    std::string error;
+
+    const size_t batches = opts.quick ? 200 : 2000;
+    return runBatched("programcache/hit", batches, 1000, [&](uint64_t i) {
+        cache.compile(sources[i % sources.size()], error);
+    });
+}
+
+// metricsInterval > 0 also samples metrics, to measure the sampler's overhead
+Result benchMacro(int numCpu, const Options& opts, uint64_t metricsInterval = 0) {
+    {
+        std::ofstream config("config.txt");
+        config << "num-cpu " << numCpu << "\n"
+               << "scheduler \"rr\"\n"
+               << "quantum-cycles 200\n"
+               << "batch-process-freq 100\n"
+               << "min-ins 100\n"
+               << "max-ins 200\n"
+               << "delays-per-exec 0\n"
+               << "max-overall-mem 65536\n"
+               << "mem-per-frame 64\n"
+               << "min-mem-per-proc 256\n"
+               << "max-mem-per-proc 256\n"
+               << "random-seed 42\n"
+               << "deterministic 1\n";
+    }
+
+    // Same number of cycles per simulated core at every size
+    const uint64_t cyclesPerCore = opts.quick ? 1000 : 5000;
+    const uint64_t totalTicks = cyclesPerCore * numCpu;
+    const uint64_t windows = 100;
+    const uint64_t windowTicks = std::max<uint64_t>(1, totalTicks / windows);
+
+    Result result;
+    result.name = "macro/rr-cores-" + std::to_string(numCpu);
+    if (metricsInterval > 0) result.name += "+metrics-" + std::to_string(metricsInterval);
+
+    auto scheduler = std::make_unique<CPUScheduler>();
+    {
+        QuietCout quiet;
+        if (!scheduler->initialize()) return result;
+        if (metricsInterval > 0) scheduler->startMetrics("metrics.bin", metricsInterval);
+        scheduler->startBatchGeneration();
+
+        auto start = BenchClock::now();
+        uint64_t allocationsBefore = allocationCount;
+        uint64_t activeBefore = scheduler->getActiveTicks();
+        for (uint64_t w = 1; w <= windows; ++w) {
+            uint64_t windowActive = scheduler->getActiveTicks();
+            auto windowStart = BenchClock::now();
+            if (!scheduler->waitForTick(w * windowTicks)) break;
+            uint64_t executed = scheduler->getActiveTicks() - windowActive;
+            if (executed > 0) {
+                result.samples.push_back(secondsSince(windowStart) * 1e9 / executed);
+            }
+        }
+        result.seconds = secondsSince(start);
+        result.allocations = allocationCount - allocationsBefore;
+        result.ops = scheduler->getActiveTicks() - activeBefore;
+
+        scheduler->shutdown();
+    }
+    return result;
+}
+
+void writeJson(std::ostream& out, const std::vector<Result>& results) {
+    out << "{\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        out << std::fixed << std::setprecision(1)
+            << "    {\"name\": \"" << r.name << "\""
+            << ", \"ops\": " << r.ops
+            << ", \"seconds\": " << std::setprecision(4) << r.seconds
+            << ", \"ops_per_sec\": " << std::setprecision(1) << (r.seconds > 0 ? r.ops / r.seconds : 0.0)
+            << ", \"p50_ns\": " << percentile(r.samples, 0.50)
+            << ", \"p99_ns\": " << percentile(r.samples, 0.99)
+            << ", \"allocs_per_op\": " << std::setprecision(2) << (r.ops > 0 ? static_cast<double>(r.allocations) / r.ops : 0.0)
+            << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opts;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            opts.filter = argv[++i];
+        } else if (std::strcmp(argv[i], "--quick") == 0) {
+            opts.quick = true;
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--filter <substring>] [--quick]" << std::endl;
+            return 1;
+        }
+    }
+
+    // The emulator writes config, backing-store and memory dump files to the
+    // working directory; keep them out of the caller's.
+    fs::path original = fs::current_path();
+    fs::path scratch = fs::temp_directory_path() / ("csopesy-bench-" + std::to_string(BenchClock::now().time_since_epoch().count()));
+    fs::create_directories(scratch);
+    fs::current_path(scratch);
+
+    struct Entry {
+        std::string name;
+        std::function<Result()> run;
+    };
+    std::vector<Entry> suite = {
+        {"interpreter/execute", [&] { return benchInterpreter(opts, false); }},
+        {"interpreter/execute-optimized", [&] { return benchInterpreter(opts, true); }},
+        {"allocator/allocate+deallocate", [&] { return benchAllocator(opts); }},
+        {"process/create-64k", [&] { return benchProcessCreate(opts); }},
+        {"process/generate-run-drop", [&] { return benchProcessLifecycle(opts); }},
+        {"pagetable/lookup-hit", [&] { return benchPageTableHit(opts); }},
+        {"pagetable/fault-evict", [&] { return benchPageTableFault(opts); }},
+        {"parser/statements-50", [&] { return benchParser(opts, 50); }},
+        {"parser/statements-10000", [&] { return benchParser(opts, 10000); }},
+        {"programcache/hit", [&] { return benchProgramCache(opts); }},
+    };
+    for (int cores : {1, 2, 4, 8, 16, 32, 64, 128}) {
+        suite.push_back({"macro/rr-cores-" + std::to_string(cores), [&opts, cores] { return benchMacro(cores, opts); }});
+    }
+    // One sample per deterministic pass: the worst case for sampler overhead
+    suite.push_back({"macro/rr-cores-8+metrics-8", [&opts] { return benchMacro(8, opts, 8); }});
+
+    std::vector<Result> results;
+    for (const Entry& entry : suite) {
+        if (!opts.filter.empty() && entry.name.find(opts.filter) == std::string::npos) continue;
+        std::cerr << "running " << entry.name << "..." << std::endl;
+        results.push_back(entry.run());
+    }
+
+    fs::current_path(original);
+    std::error_code ec;
+    fs::remove_all(scratch, ec);
+
+    writeJson(std::cout, results);
+    return 0;
+}
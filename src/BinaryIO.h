@@ -0,0 +1,132 @@
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Little-endian binary encoding shared by the run traces, checkpoints and
+// compiled workload files. Integers that are usually small go through LEB128
+// varints; signed values are zigzag-encoded first.
+class BinaryWriter {
+public:
+    void u8(uint8_t value) { buffer.push_back(value); }
+
+    void u16(uint16_t value) { fixed(value); }
+    void u32(uint32_t value) { fixed(value); }
+    void u64(uint64_t value) { fixed(value); }
+
+    void varint(uint64_t value) {
+        while (value >= 0x80) {
+            buffer.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        buffer.push_back(static_cast<uint8_t>(value));
+    }
+
+    void svarint(int64_t value) {
+        varint((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+    }
+
+    void str(std::string_view text) {
+        varint(text.size());
+        bytes(text.data(), text.size());
+    }
+
+    void bytes(const void* data, size_t size) {
+        const uint8_t* p = static_cast<const uint8_t*>(data);
+        buffer.insert(buffer.end(), p, p + size);
+    }
+
+    size_t size() const { return buffer.size(); }
+    const std::vector<uint8_t>& data() const { return buffer; }
+    std::vector<uint8_t>& data() { return buffer; }
+    void clear() { buffer.clear(); }
+
+    bool appendTo(std::ofstream& out) const {
+        out.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+        return static_cast<bool>(out);
+    }
+
+private:
+    template <typename T>
+    void fixed(T value) {
+        for (size_t i = 0; i < sizeof(T); ++i) {
+            buffer.push_back(static_cast<uint8_t>(value >> (8 * i)));
+        }
+    }
+
+    std::vector<uint8_t> buffer;
+};
+
+// Bounds-checked reader over a byte range it does not own. A read past the
+// end sets failed() and returns zeros, so callers check once at the end.
+class BinaryReader {
+public:
+    BinaryReader() = default;
+    BinaryReader(const uint8_t* data, size_t size) : begin(data), cursor(data), end(data + size) {}
+
+    uint8_t u8() { return fixed<uint8_t>(); }
+    uint16_t u16() { return fixed<uint16_t>(); }
+    uint32_t u32() { return fixed<uint32_t>(); }
+    uint64_t u64() { return fixed<uint64_t>(); }
+
+    uint64_t varint() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (cursor >= end) {
+                failed_ = true;
+                return 0;
+            }
+            uint8_t byte = *cursor++;
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return value;
+        }
+        failed_ = true;
+        return 0;
+    }
+
+    int64_t svarint() {
+        uint64_t raw = varint();
+        return static_cast<int64_t>(raw >> 1) ^ -static_cast<int64_t>(raw & 1);
+    }
+
+    // View into the underlying buffer; valid as long as the buffer is
+    std::string_view str() {
+        uint64_t size = varint();
+        const uint8_t* p = take(size);
+        return p ? std::string_view(reinterpret_cast<const char*>(p), size) : std::string_view();
+    }
+
+    const uint8_t* take(uint64_t size) {
+        if (static_cast<uint64_t>(end - cursor) < size) {
+            failed_ = true;
+            cursor = end;
+            return nullptr;
+        }
+        const uint8_t* p = cursor;
+        cursor += size;
+        return p;
+    }
+
+    bool atEnd() const { return cursor >= end; }
+    bool failed() const { return failed_; }
+    size_t offset() const { return static_cast<size_t>(cursor - begin); }
+
+private:
+    template <typename T>
+    T fixed() {
+        const uint8_t* p = take(sizeof(T));
+        if (!p) return 0;
+        T value = 0;
+        for (size_t i = 0; i < sizeof(T); ++i) {
+            value |= static_cast<T>(static_cast<T>(p[i]) << (8 * i));
+        }
+        return value;
+    }
+
+    const uint8_t* begin = nullptr;
+    const uint8_t* cursor = nullptr;
+    const uint8_t* end = nullptr;
+    bool failed_ = false;
+};
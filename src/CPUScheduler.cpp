@@ -1,11 +1,33 @@
 #include "CPUScheduler.h"
 #include "MemoryManager.h"  // new addition
+#include "TimeFormat.h"
+#include "Json.h"
+#include "Checkpoint.h"
+#include "ProgramCodec.h"
+#include "ProcessPool.h"
+#include "WorkloadFile.h"
 #include <iostream>
 #include <fstream>
 #include <iomanip>
 #include <algorithm>
 #include <memory> 
+#include <limits>
+#include <random>
 
+namespace {
+
+// Page events raised while this thread holds schedulerMutex (admission
+// allocates under it). Replay checks can end in finishReplay(), which takes
+// the lock, so those events are emitted once the critical section is over.
+struct DeferredPageEvent {
+    bool pageIn;
+    int pid;
+    int page;
+    int frame;
+};
+thread_local std::vector<DeferredPageEvent>* deferredPageEvents = nullptr;
+
+} // namespace
 
 CPUScheduler::~CPUScheduler() {
     shutdown();
@@ -21,28 +43,92 @@ bool CPUScheduler::initialize() {
         std::cout << "Error: Could not load config.txt" << std::endl;
         return false;
     }
-    
+
+    uint64_t seed = config.getRandomSeed();
+    if (seed == 0) {
+        std::random_device rd;
+        seed = (static_cast<uint64_t>(rd()) << 32) | rd();
+    }
+
+    // A recording is only replayable if the run was deterministic
+    return start(seed, config.isDeterministic() || !recordFile.empty());
+}
+
+bool CPUScheduler::start(uint64_t seed, bool deterministicMode, const checkpoint::File* from) {
+    deterministic = deterministicMode;
+    finishedArchive.reset(config.getFinishedArchiveSize());
+    programCache.reset(config.getProgramCacheSize(), config.isOptimize());
+    workload.configure(config, seed);
+
     memoryManager.init(             // new addition
     config.getMaxOverallMem(),
     config.getMemPerFrame(),
     config.getMaxMemPerProc()
     );
+    memoryManager.setPageEventHandler([this](FirstFitMemoryAllocator::PageEvent event, int pid, int page, int frame) {
+        bool pageIn = event == FirstFitMemoryAllocator::PageEvent::PageIn;
+        if (deferredPageEvents) {
+            deferredPageEvents->push_back(DeferredPageEvent{pageIn, pid, page, frame});
+        } else {
+            onPageEvent(pageIn, pid, page, frame);
+        }
+    });
 
     schedulerRunning = true;
-    
-    // Start CPU tick counter
-    std::thread tickThread(&CPUScheduler::tickCounter, this);
-    tickThread.detach();
-    
-    // Start core worker threads
-    coreThreads.reserve(config.getNumCpu());
-    for (int i = 0; i < config.getNumCpu(); i++) {
-        coreThreads.emplace_back(&CPUScheduler::coreWorker, this, i);
+    clock.reset();
+
+    if (!recordFile.empty()) {
+        if (!recorder.start(recordFile, configHeader(seed))) {
+            std::cout << "Error: Could not create " << recordFile << "; not recording." << std::endl;
+            recordFile.clear();
+        }
+    }
+    tracing = recorder.isActive() || replaying;
+
+    // Simulated cores are multiplexed over at most one worker per host thread
+    int numCpu = config.getNumCpu();
+    int hostThreads = static_cast<int>(std::thread::hardware_concurrency());
+    int workerCount = std::max(1, std::min(numCpu, hostThreads));
+
+    cores.clear();
+    cores.reserve(numCpu);
+    for (int i = 0; i < numCpu; i++) {
+        cores.emplace_back(i);
+        // Deterministic mode counts delays in CPU ticks instead (SimCore::stall)
+        if (!deterministic) {
+            cores.back().pacer.setPeriod(std::chrono::milliseconds(config.getDelaysPerExec() * 10));
+        }
+    }
+    startTime = std::chrono::steady_clock::now();
+
+    if (from) {
+        std::string error;
+        if (!loadState(*from, error)) {
+            std::cout << "Error: Could not restore checkpoint: " << error << std::endl;
+            discardRunState();
+            schedulerRunning = false;
+            return false;
+        }
+    }
+
+    if (deterministic) {
+        workerThreads.emplace_back(&CPUScheduler::deterministicWorker, this);
+    } else {
+        workerThreads.reserve(workerCount);
+        for (int i = 0; i < workerCount; i++) {
+            workerThreads.emplace_back(&CPUScheduler::coreWorker, this, i, workerCount);
+        }
     }
     
     initialized = true;
     std::cout << "Scheduler initialized with " << config.getNumCpu() << " CPU cores using " 
               << config.getScheduler() << " scheduling algorithm." << std::endl;
+    if (deterministic) {
+        std::cout << "Deterministic mode, random seed " << seed << "." << std::endl;
+    }
+    if (recorder.isActive()) {
+        std::cout << "Recording run to " << recordFile << "." << std::endl;
+    }
     return true;
 }
 
@@ -57,7 +143,28 @@ void CPUScheduler::startBatchGeneration() {
         return;
     }
     
+    if (deterministic) {
+        // The worker admits batch arrivals itself at pass boundaries
+        {
+            std::lock_guard<std::mutex> lock(schedulerMutex);
+            if (!loadGenerator.configure(config, workload.getSeed())) {
+                return;
+            }
+            loadGenerator.begin(clock.now());
+            batchArrivalPending = false;
+            batchGenerationRunning = true;
+        }
+        cv.notify_all();
+        std::cout << "Batch process generation started." << std::endl;
+        return;
+    }
+
+    if (!loadGenerator.configure(config, workload.getSeed())) {
+        return;
+    }
+
     batchGenerationRunning = true;
+    workload.start(config.getGeneratorThreads(), processCounter);
     batchGeneratorThread = std::thread(&CPUScheduler::batchGenerator, this);
     std::cout << "Batch process generation started." << std::endl;
     // std::cout << cpuTicks << " CPU ticks accumulated." << std::endl;
@@ -69,211 +176,355 @@ void CPUScheduler::stopBatchGeneration() {
         return;
     }
     
-    batchGenerationRunning = false;
+    {
+        std::lock_guard<std::mutex> lock(schedulerMutex);
+        batchGenerationRunning = false;
+    }
+    workload.stop();
+    clock.wakeAll();
     if (batchGeneratorThread.joinable()) {
         batchGeneratorThread.join();
     }
     std::cout << "Batch process generation stopped." << std::endl;
 }
 
-void CPUScheduler::addProcess(const std::string& name, int memSize) {
+bool CPUScheduler::addProcess(const std::string& name, int memSize) {
     if (!initialized) {
         std::cout << "Please initialize the scheduler first." << std::endl;
-        return;
+        return false;
     }
 
-    int actualMemSize = memSize;
-    if (memSize == -1) {
-        int minMem = config.getMinMemPerProc();
-        int maxMem = config.getMaxMemPerProc();
-        std::vector<int> powers;
-        for (int p = 6; p <= 16; ++p) {
-            int val = 1 << p;
-            if (val >= minMem && val <= maxMem) powers.push_back(val);
+    Admission admission;
+    admission.process = workload.build(name, static_cast<int>(processCounter++), memSize);
+    if (!claimName(admission.process)) {
+        std::cout << "Process " << name << " already exists." << std::endl;
+        return false;
+    }
+    submit(std::move(admission));
+    return true;
+}
+
+bool CPUScheduler::submit(Admission admission) {
+    {
+        std::lock_guard<std::mutex> lock(schedulerMutex);
+        registerLocked(admission.process);
+        if (deterministic) {
+            pendingAdmissions.push_back(std::move(admission));
         }
-        if (!powers.empty()) {
-            actualMemSize = powers[rand() % powers.size()];
-        } else {
-            actualMemSize = minMem;
+    }
+    if (!deterministic) {
+        return admit(admission);
+    }
+    cv.notify_all();
+    return true;
+}
+
+int CPUScheduler::submitProcess(const std::string& name, int memSize, const std::string& instructions, std::string& error) {
+    if (!initialized) {
+        error = "scheduler not initialized";
+        return -1;
+    }
+    if (name.empty()) {
+        error = "missing process name";
+        return -1;
+    }
+    bool generated = instructions.empty();
+    if (!(generated && memSize == 0) && (memSize < 64 || memSize > 65536 || (memSize & (memSize - 1)) != 0)) {
+        error = "invalid memory allocation";
+        return -1;
+    }
+    if (!checkExistingProcess(name)) { // cheap early out; claimName below is authoritative
+        error = "process " + name + " already exists";
+        return -1;
+    }
+
+    int pid = static_cast<int>(processCounter++);
+    Admission admission;
+    admission.quiet = true;
+    if (generated) {
+        admission.process = workload.build(name, pid, memSize == 0 ? -1 : memSize);
+    } else {
+        ProgramPtr program = programCache.compile(instructions, error);
+        if (!program) {
+            return -1;
         }
+
+        admission.process = ProcessPool::make(name, pid, memSize);
+        admission.process->setProgram(std::move(program));
+        admission.source = instructions;
+        admission.allocate = false; // same as screen -c
     }
 
-    auto process = std::make_shared<Process>(name, processCounter++, actualMemSize);
-    process->generateRandomInstructions(config.getMinIns(), config.getMaxIns());
+    if (!claimName(admission.process)) {
+        error = "process " + name + " already exists";
+        return -1;
+    }
+    if (!submit(std::move(admission))) {
+        error = "could not allocate memory";
+        return -1;
+    }
+    return pid;
+}
+
+bool CPUScheduler::admit(Admission& admission) {
+    const ProcessPtr& process = admission.process;
+    tracer.nameProcess(process->pid, process->name);
+    if (tracing) {
+        emitRunEvent(RunEventType::Arrival, -1, process->pid, process->memorySize, admission.insOverride,
+                     process->name, admission.source);
+    }
 
-    // Try to allocate memory right away
-    if (!memoryManager.allocate(process)) {
-        std::cout << "[MEM FAIL] Could not allocate memory for process " << process->name << "\n";
-        return; // skip adding process if memory full
+    process->arrivalTick = clock.now();
+
+    // Allocation and enqueue happen in one critical section, so a checkpoint
+    // never sees a process that holds memory but is in no queue
+    bool admitted;
+    std::vector<DeferredPageEvent> pageEvents;
+    {
+        std::lock_guard<std::mutex> lock(schedulerMutex);
+        deferredPageEvents = &pageEvents;
+        admitted = !admission.allocate || memoryManager.allocate(process);
+        deferredPageEvents = nullptr;
+        if (admitted) {
+            registerLocked(process);
+            process->readySinceTick = clock.now();
+            readyQueue.push(process);
+            readyCount++;
+        } else {
+            unregisterLocked(process);
+        }
+    }
+    for (const DeferredPageEvent& event : pageEvents) {
+        onPageEvent(event.pageIn, event.pid, event.page, event.frame);
+    }
+    if (!admitted) {
+        if (!admission.quiet) {
+            std::cout << "[MEM FAIL] Could not allocate memory for process " << process->name << "\n";
+        }
+        return false; // skip adding process if memory full
     }
+    cv.notify_one();
+    return true;
+}
 
+void CPUScheduler::enqueueReady(const ProcessPtr& process) {
+    process->readySinceTick = clock.now();
     {
         std::lock_guard<std::mutex> lock(schedulerMutex);
         readyQueue.push(process);
+        readyCount++;
     }
     cv.notify_one();
 }
 
 ProcessPtr CPUScheduler::getProcess(const std::string& name) {
     std::lock_guard<std::mutex> lock(schedulerMutex);
-    
-    // Check running processes
-    auto it = std::find_if(runningProcesses.begin(), runningProcesses.end(),
-        [&name](const ProcessPtr& process) { return process->name == name; });
-    if (it != runningProcesses.end()) return *it;
-    
-
-
-    // Check ready queue
-    std::queue<ProcessPtr> tempQueue = readyQueue;
-    while (!tempQueue.empty()) {
-        auto process = tempQueue.front();
-        tempQueue.pop();
-        if (process->name == name) return process;
-    }
-    
-    return nullptr;
+    auto it = liveByName.find(name);
+    return it != liveByName.end() ? it->second : nullptr;
 }
 
-ProcessPtr CPUScheduler::getAllProcess(const std::string& name) {
+bool CPUScheduler::getFinishedSummary(const std::string& name, ProcessSummary& out) const {
     std::lock_guard<std::mutex> lock(schedulerMutex);
-    
-    // Check running processes
-    auto it = std::find_if(runningProcesses.begin(), runningProcesses.end(),
-        [&name](const ProcessPtr& process) { return process->name == name; });
-    if (it != runningProcesses.end()) return *it;
-    
-    
-    // Check finished processes
-    it = std::find_if(finishedProcesses.begin(), finishedProcesses.end(),
-        [&name](const ProcessPtr& process) { return process->name == name; });
-    if (it != finishedProcesses.end()) return *it;
-    
-
-    // Check ready queue
-    std::queue<ProcessPtr> tempQueue = readyQueue;
-    while (!tempQueue.empty()) {
-        auto process = tempQueue.front();
-        tempQueue.pop();
-        if (process->name == name) return process;
-    }
-    
-    return nullptr;
+    const ProcessSummary* summary = finishedArchive.findByName(name);
+    if (!summary) return false;
+    out = *summary;
+    return true;
 }
 
 ProcessPtr CPUScheduler::getProcessByPID(int pid) {
     std::lock_guard<std::mutex> lock(schedulerMutex);
+    auto it = liveByPid.find(pid);
+    return it != liveByPid.end() ? it->second : nullptr;
+}
 
-    // Check running processes
-    auto it = std::find_if(runningProcesses.begin(), runningProcesses.end(),
-        [pid](const ProcessPtr& process) { return process->pid == pid; });
-    if (it != runningProcesses.end()) return *it;
-
-    // Check finished processes
-    it = std::find_if(finishedProcesses.begin(), finishedProcesses.end(),
-        [pid](const ProcessPtr& process) { return process->pid == pid; });
-    if (it != finishedProcesses.end()) return *it;
+bool CPUScheduler::checkExistingProcess(const std::string& name) {
+    std::lock_guard<std::mutex> lock(schedulerMutex);
+    return liveByName.find(name) == liveByName.end();
+}
 
-    // Check ready queue
-    std::queue<ProcessPtr> tempQueue = readyQueue;
-    while (!tempQueue.empty()) {
-        auto process = tempQueue.front();
-        tempQueue.pop();
-        if (process->pid == pid) return process;
-    }
+// Registers a new process unless its name is already live. The check and the
+// insert share one critical section, so concurrent submitters (console and
+// control clients) can't both admit the same name.
+bool CPUScheduler::claimName(const ProcessPtr& process) {
+    std::lock_guard<std::mutex> lock(schedulerMutex);
+    if (liveByName.find(process->name) != liveByName.end()) return false;
+    registerLocked(process);
+    return true;
+}
 
-    
+// Live processes are indexed from submission until they finish. Requires schedulerMutex.
+void CPUScheduler::registerLocked(const ProcessPtr& process) {
+    liveByName[process->name] = process;
+    liveByPid[process->pid] = process;
+}
 
-    return nullptr;
+void CPUScheduler::unregisterLocked(const ProcessPtr& process) {
+    auto byName = liveByName.find(process->name);
+    if (byName != liveByName.end() && byName->second == process) liveByName.erase(byName);
+    auto byPid = liveByPid.find(process->pid);
+    if (byPid != liveByPid.end() && byPid->second == process) liveByPid.erase(byPid);
 }
 
+// Summary with the allocator's view of the process. Requires schedulerMutex.
+ProcessSummary CPUScheduler::summarizeLocked(const ProcessPtr& process) const {
+    ProcessSummary summary(*process);
+    summary.memoryAllocated = memoryManager.isAllocated(process);
+    ProcessPageStats pages = memoryManager.getPageStats(process->pid);
+    summary.pageFaults = pages.faults;
+    summary.evictions = pages.evictions;
+    summary.residentBytes = pages.residentPages * memoryManager.getMemPerFrame();
+    return summary;
+}
 
+SchedulerSnapshot CPUScheduler::takeSnapshot(bool includeWaiting, size_t maxFinished) const {
+    SchedulerSnapshot snap;
+    std::lock_guard<std::mutex> lock(schedulerMutex);
 
+    snap.numCpu = config.getNumCpu();
+    snap.totalMemory = memoryManager.getTotalMemory();
+    snap.usedMemory = memoryManager.getUsedMemory();
+    snap.memPerFrame = memoryManager.getMemPerFrame();
+    snap.pageIns = memoryManager.getPageIns();
+    snap.pageOuts = memoryManager.getPageOuts();
 
-bool CPUScheduler::checkExistingProcess(const std::string& name) {
+    auto summarize = [this](const ProcessPtr& process) { return summarizeLocked(process); };
 
+    snap.running.reserve(runningProcesses.size());
+    for (const auto& process : runningProcesses) {
+        snap.running.push_back(summarize(process));
+    }
 
-    std::lock_guard<std::mutex> lock(schedulerMutex);
-    
-    auto it = std::find_if(runningProcesses.begin(), runningProcesses.end(),
-        [&name](const ProcessPtr& process) { return process->name == name; });
-    if (it != runningProcesses.end()) return false;
-    
+    if (includeWaiting) {
+        std::queue<ProcessPtr> tempQueue = readyQueue;
+        snap.waiting.reserve(tempQueue.size());
+        while (!tempQueue.empty()) {
+            snap.waiting.push_back(summarize(tempQueue.front()));
+            tempQueue.pop();
+        }
+    }
 
-    std::queue<ProcessPtr> tempQueue = readyQueue;
-    while (!tempQueue.empty()) {
-        auto process = tempQueue.front();
-        tempQueue.pop();
-        if (process->name == name) return false;
+    snap.finishedTotal = finishedArchive.totalArchived();
+    snap.finishedDropped = finishedArchive.dropped();
+    size_t first = finishedArchive.size() > maxFinished ? finishedArchive.size() - maxFinished : 0;
+    snap.finished.reserve(finishedArchive.size() - first);
+    for (size_t i = first; i < finishedArchive.size(); ++i) {
+        snap.finished.push_back(finishedArchive.at(i));
     }
-    
-    return true; 
+
+    return snap;
 }
 
-void CPUScheduler::listProcesses() {
-    std::lock_guard<std::mutex> lock(schedulerMutex);
-    
-    double cpuUtilization = getCpuUtilization();
-    int coresUsed = getCoresUsed();
-    int coresAvailable = getCoresAvailable();
+void CPUScheduler::writeUtilization(std::ostream& out, const SchedulerSnapshot& snap, bool showPid) {
+    int coresUsed = static_cast<int>(snap.running.size());
+    double cpuUtilization = static_cast<double>(coresUsed) / snap.numCpu * 100.0;
     
-    std::cout << "CPU utilization: " << std::fixed << std::setprecision(2) 
-              << cpuUtilization << "%" << std::endl;
-    std::cout << "Cores used: " << coresUsed << std::endl;
-    std::cout << "Cores available: " << coresAvailable << std::endl;
-    std::cout << std::endl;
+    out << "CPU utilization: " << std::fixed << std::setprecision(2) 
+        << cpuUtilization << "%" << std::endl;
+    out << "Cores used: " << coresUsed << std::endl;
+    out << "Cores available: " << (snap.numCpu - coresUsed) << std::endl;
+    out << std::endl;
     
-    std::cout << "Running processes:" << std::endl;
-    for (const auto& process : runningProcesses) {
-        std::cout << process->name << " pid: " << process->pid << "\t(" << process->creationTime 
-                  << ")\tCore: " << process->assignedCore << "\t"
-                  << process->currentInstruction << " / " 
-                  << process->totalInstructions << std::endl;
+    out << "Running processes:" << std::endl;
+    for (const auto& process : snap.running) {
+        out << process.name;
+        if (showPid) out << " pid: " << process.pid;
+        out << "\t(" << TimeFormat::format(process.creationTime) 
+            << ")\tCore: " << process.assignedCore << "\t"
+            << process.currentInstruction << " / " 
+            << process.totalInstructions << std::endl;
     }
     
-    std::cout << std::endl << "Finished processes:" << std::endl;
-    for (const auto& process : finishedProcesses) {
-        std::cout << process->name << "\t(" << process->creationTime 
-                  << ")\tFinished\t" << process->finishTime << "\t"
-                  << process->totalInstructions << " / " 
-                  << process->totalInstructions << std::endl;
+    out << std::endl << "Finished processes:" << std::endl;
+    if (snap.finishedDropped > 0) {
+        out << "(" << snap.finishedDropped << " older finished processes not retained)" << std::endl;
     }
+    for (const auto& process : snap.finished) {
+        out << process.name << "\t(" << TimeFormat::format(process.creationTime) 
+            << ")\tFinished\t" << TimeFormat::format(process.finishTime) << "\t"
+            << process.totalInstructions << " / " 
+            << process.totalInstructions << std::endl;
+    }
+}
+
+void CPUScheduler::writeLatency(std::ostream& out) const {
+    out << "Scheduling latency (CPU ticks):" << std::endl;
+    out << std::left << std::setw(14) << "Metric" << std::right
+        << std::setw(10) << "Count" << std::setw(10) << "p50" << std::setw(10) << "p90"
+        << std::setw(10) << "p99" << std::setw(10) << "Max" << std::endl;
+
+    auto row = [&out](const char* label, const LatencyHistogram& h) {
+        out << std::left << std::setw(14) << label << std::right
+            << std::setw(10) << h.count() << std::setw(10) << h.percentile(0.50)
+            << std::setw(10) << h.percentile(0.90) << std::setw(10) << h.percentile(0.99)
+            << std::setw(10) << h.max() << std::endl;
+    };
+    row("Response", latency.response);
+    row("Waiting", latency.waiting);
+    row("Turnaround", latency.turnaround);
+    row("Ready queue", latency.readyQueue);
+}
+
+void CPUScheduler::printStats() const {
+    std::cout << std::endl;
+    writeLatency(std::cout);
+    std::cout << std::endl
+              << "Response: arrival to first dispatch. Waiting: total time ready but not running." << std::endl
+              << "Turnaround: arrival to finish. Ready queue: each stay in the queue." << std::endl;
+}
+
+void CPUScheduler::writeResultsJson(std::ostream& out) const {
+    SchedulerSnapshot snap = takeSnapshot(true, 0);
+    uint64_t ticks = clock.now();
+    uint64_t active = activeCpuTicks;
+
+    out << "{\"cpu_ticks\":" << ticks
+        << ",\"active_ticks\":" << active
+        << ",\"idle_ticks\":" << (ticks - active)
+        << ",\"running\":" << snap.running.size()
+        << ",\"waiting\":" << snap.waiting.size()
+        << ",\"finished\":" << snap.finishedTotal
+        << ",\"total_memory\":" << snap.totalMemory
+        << ",\"used_memory\":" << snap.usedMemory
+        << ",\"page_ins\":" << snap.pageIns
+        << ",\"page_outs\":" << snap.pageOuts;
+
+    const ProgramCache::Stats cache = programCache.getStats();
+    out << ",\"program_cache\":{\"entries\":" << cache.entries << ",\"capacity\":" << cache.capacity
+        << ",\"hits\":" << cache.hits << ",\"misses\":" << cache.misses << ",\"evictions\":" << cache.evictions << "}";
+
+    const SparseMemory::Stats processMemory = SparseMemory::getStats();
+    out << ",\"process_memory\":{\"reserved\":" << processMemory.reserved
+        << ",\"resident\":" << processMemory.resident << "}";
+
+    auto metric = [&out](const char* key, const LatencyHistogram& h) {
+        out << ",\"" << key << "\":{\"count\":" << h.count()
+            << ",\"p50\":" << h.percentile(0.50) << ",\"p90\":" << h.percentile(0.90)
+            << ",\"p99\":" << h.percentile(0.99) << ",\"max\":" << h.max() << "}";
+    };
+    metric("response_time", latency.response);
+    metric("waiting_time", latency.waiting);
+    metric("turnaround_time", latency.turnaround);
+    metric("ready_queue_time", latency.readyQueue);
+    out << "}";
+}
+
+void CPUScheduler::listProcesses() {
+    SchedulerSnapshot snap = takeSnapshot(false, SIZE_MAX);
+    writeUtilization(std::cout, snap, true);
 }
 
 void CPUScheduler::generateReport() {
+    SchedulerSnapshot snap = takeSnapshot(false, SIZE_MAX);
+
     std::ofstream file("csopesy-log.txt");
     if (!file.is_open()) {
         std::cout << "Error: Could not create csopesy-log.txt" << std::endl;
         return;
     }
     
-    std::lock_guard<std::mutex> lock(schedulerMutex);
-    
-    double cpuUtilization = getCpuUtilization();
-    int coresUsed = getCoresUsed();
-    int coresAvailable = getCoresAvailable();
-    
-    file << "CPU utilization: " << std::fixed << std::setprecision(2) 
-         << cpuUtilization << "%" << std::endl;
-    file << "Cores used: " << coresUsed << std::endl;
-    file << "Cores available: " << coresAvailable << std::endl;
+    writeUtilization(file, snap, false);
     file << std::endl;
-    
-    file << "Running processes:" << std::endl;
-    for (const auto& process : runningProcesses) {
-        file << process->name << "\t(" << process->creationTime 
-             << ")\tCore: " << process->assignedCore << "\t"
-             << process->currentInstruction << " / " 
-             << process->totalInstructions << std::endl;
-    }
-    
-    file << std::endl << "Finished processes:" << std::endl;
-    for (const auto& process : finishedProcesses) {
-        file << process->name << "\t(" << process->creationTime 
-             << ")\tFinished\t" << process->finishTime << "\t"
-             << process->totalInstructions << " / " 
-             << process->totalInstructions << std::endl;
-    }
+    writeLatency(file);
     
     file.close();
     std::cout << "Report generated: csopesy-log.txt" << std::endl;
@@ -284,9 +535,14 @@ void CPUScheduler::shutdown() {
     
     schedulerRunning = false;
     batchGenerationRunning = false;
-    cv.notify_all();
+    workload.stop();
+    {
+        std::lock_guard<std::mutex> lock(schedulerMutex);
+        cv.notify_all();
+    }
+    clock.interrupt();
     
-    for (auto& thread : coreThreads) {
+    for (auto& thread : workerThreads) {
         if (thread.joinable()) {
             thread.join();
         }
@@ -296,133 +552,914 @@ void CPUScheduler::shutdown() {
         batchGeneratorThread.join();
     }
     
-    coreThreads.clear();
+    workerThreads.clear();
+    if (metrics.isEnabled()) stopMetrics();
     initialized = false;
 }
 
-void CPUScheduler::tickCounter() {
-    while (schedulerRunning) {
-        cpuTicks += config.getNumCpu();
+void CPUScheduler::batchGenerator() {
+    loadGenerator.begin(clock.now());
+    Arrival arrival;
+    while (batchGenerationRunning && schedulerRunning && loadGenerator.next(arrival)) {
+        if (!clock.waitUntil(arrival.tick, &batchGenerationRunning)) break;
+
+        // Generator threads usually have the process ready, so admission only
+        // allocates and enqueues. Trace entries that pin a size are built here.
+        Admission admission;
+        admission.quiet = true;
+        admission.insOverride = arrival.instructions;
+        if (arrival.memSize != -1 || arrival.instructions != -1) {
+            int pid = static_cast<int>(processCounter++);
+            admission.process = workload.build("p" + std::to_string(pid), pid, arrival.memSize, arrival.instructions);
+        } else {
+            admission.process = workload.take();
+        }
+        if (!admission.process) break;
+
+        admit(admission);
     }
 }
 
-void CPUScheduler::batchGenerator() {
-    int lastTick = cpuTicks;
-    while (batchGenerationRunning && schedulerRunning) {
-        if (static_cast<unsigned long>(cpuTicks - lastTick) >= config.getBatchProcessFreq()) {
-            std::string processName = "p" + std::to_string(processCounter++);
-            int minMem = config.getMinMemPerProc();
-            int maxMem = config.getMaxMemPerProc();
-            std::vector<int> powers;
-            for (int p = 6; p <= 16; ++p) {
-                int val = 1 << p;
-                if (val >= minMem && val <= maxMem) powers.push_back(val);
-            }
-            int memSize = minMem;
-            if (!powers.empty()) memSize = powers[rand() % powers.size()];
+void CPUScheduler::coreWorker(int workerId, int workerCount) {
+    using SteadyClock = CorePacer::Clock;
+    // Idle cores still burn a CPU cycle; pace those so an idle pool doesn't spin
+    constexpr auto idleCyclePeriod = std::chrono::milliseconds(1);
+    // Most overdue instructions a paced core may retire in one pass
+    constexpr int maxCatchUp = 64;
 
-            auto process = std::make_shared<Process>(processName, processCounter - 1, memSize);
-            process->generateRandomInstructions(config.getMinIns(), config.getMaxIns());
+    std::vector<SimCore*> owned;
+    for (size_t i = workerId; i < cores.size(); i += workerCount) {
+        owned.push_back(&cores[i]);
+    }
 
-            // Try to allocate memory right away
-            if (!memoryManager.allocate(process)) {
-                // std::cout << "[MEM FAIL] Could not allocate memory for process " << process->name << "\n";
-            } else {
-                {
-                    std::lock_guard<std::mutex> lock(schedulerMutex);
-                    readyQueue.push(process);
-                }
-                cv.notify_one();
+    while (schedulerRunning) {
+        if (pauseRequested) parkWorker();
+        auto now = SteadyClock::now();
+        auto nextDue = SteadyClock::time_point::max();
+        bool executed = false;
+        bool hasIdleCore = false;
+        uint64_t cycles = 0;
+
+        for (SimCore* core : owned) {
+            bool paced = core->pacer.isEnabled();
+            if (core->process && paced && !core->pacer.isDue(now)) {
+                nextDue = std::min(nextDue, core->pacer.nextDeadline());
+                continue;
             }
 
-            lastTick = cpuTicks;
+            // A paced core that is behind schedule retires its overdue
+            // instructions now rather than waiting once per instruction
+            int burst = 0;
+            do {
+                executed |= stepCore(*core, now);
+                cycles++;
+            } while (paced && core->process && core->pacer.isDue(now) && ++burst < maxCatchUp);
+
+            if (!core->process) {
+                hasIdleCore = true;
+            } else if (paced) {
+                nextDue = std::min(nextDue, core->pacer.nextDeadline());
+            }
+        }
+        clock.advance(cycles);
+        if (metrics.isDue(clock.now())) {
+            uint64_t tick = clock.now();
+            if (metrics.claim(tick)) sampleMetrics(tick);
+        }
+
+        if (!executed) {
+            // Every busy core is ahead of its deadline: one wait covers them all.
+            // Idle cores keep ticking at the idle cycle rate meanwhile.
+            auto wakeAt = hasIdleCore ? std::min(nextDue, now + idleCyclePeriod) : nextDue;
+            std::unique_lock<std::mutex> lock(schedulerMutex);
+            cv.wait_until(lock, wakeAt, [this, hasIdleCore] {
+                return !schedulerRunning || pauseRequested || (hasIdleCore && !readyQueue.empty());
+            });
         }
     }
 }
 
-void CPUScheduler::coreWorker(int coreId) {
+// Deterministic mode: every pass steps all cores in id order on this thread,
+// then advances the clock by one tick per core. Admissions only happen at pass
+// boundaries, and idle stretches jump straight to the next arrival.
+void CPUScheduler::deterministicWorker() {
+    const unsigned long stallCycles = config.getDelaysPerExec();
+
     while (schedulerRunning) {
-        ProcessPtr process = nullptr;
-        {
-            std::unique_lock<std::mutex> lock(schedulerMutex);
-            cv.wait(lock, [this] { return !readyQueue.empty() || !schedulerRunning; });
-            if (!schedulerRunning) break;
-            if (!readyQueue.empty()) {
-                process = readyQueue.front();
-                readyQueue.pop();    
-                process->assignedCore = coreId;
-                process->remainingQuantum = config.getQuantumCycles();
-                runningProcesses.push_back(process);
-            } 
+        if (pauseRequested) parkWorker();
+        admitDue();
+
+        bool busy = false;
+        for (SimCore& core : cores) {
+            if (core.process && core.stall > 0) {
+                // Busy-waiting between instructions still counts as an active tick
+                core.stall--;
+                activeCpuTicks++;
+                core.process->cpuTicks++;
+                busy = true;
+                continue;
+            }
+            if (stepCore(core, CorePacer::Clock::time_point{}) && core.process) {
+                core.stall = stallCycles;
+            }
+            busy |= static_cast<bool>(core.process);
         }
+        clock.advance(cores.size());
+        if (metrics.isDue(clock.now())) {
+            uint64_t tick = clock.now();
+            if (metrics.claim(tick)) sampleMetrics(tick);
+        }
+
+        if (busy || readyCount > 0) continue;
 
-        if (!process) {
+        std::unique_lock<std::mutex> lock(schedulerMutex);
+        uint64_t now = clock.now();
+        if (idleWakeTick <= now) idleWakeTick = std::numeric_limits<uint64_t>::max();
+        uint64_t next = std::min(nextArrivalTickLocked(), idleWakeTick);
+        if (next != std::numeric_limits<uint64_t>::max()) {
+            if (next > now) clock.advance(next - now);
             continue;
         }
+        if (replaying) {
+            lock.unlock();
+            replayer.fail("run went idle with no recorded arrivals left");
+            finishReplay();
+            continue;
+        }
+        // Nothing to run and nothing scheduled: virtual time stands still
+        cv.wait(lock, [this] {
+            return !schedulerRunning || pauseRequested || idleWakeTick != std::numeric_limits<uint64_t>::max() ||
+                   nextArrivalTickLocked() != std::numeric_limits<uint64_t>::max();
+        });
+    }
+}
 
-        // Memory is already allocated in addProcess()/batchGenerator()
+bool CPUScheduler::waitForTick(uint64_t tick) {
+    if (deterministic) {
+        // Virtual time stands still while idle; tell the worker how far to skip
+        {
+            std::lock_guard<std::mutex> lock(schedulerMutex);
+            idleWakeTick = std::min(idleWakeTick, tick);
+        }
+        cv.notify_all();
+    }
+    return clock.waitUntil(tick, &schedulerRunning);
+}
 
-        bool processRunning = true;
-        while (processRunning && schedulerRunning) {
-            // Mark as active tick
-            {
-                std::lock_guard<std::mutex> lock(schedulerMutex);
-                activeCpuTicks++;
-            }
-            bool stillRunning = process->executeNextInstruction(coreId);
-
-            // Memory dump logic
-            int newQuantumCycle = cpuTicks / config.getQuantumCycles();
-            if (newQuantumCycle > currentQuantumCycle) {
-                currentQuantumCycle = newQuantumCycle;
-                quantumCycleCount++;
-                memoryManager.dumpStatusToFile(quantumCycleCount);
-            }
+// Tick of the next admission this worker knows about. Requires schedulerMutex.
+uint64_t CPUScheduler::nextArrivalTickLocked() {
+    if (!pendingAdmissions.empty()) return clock.now();
+    if (replaying) return replayer.nextArrivalTick();
+    if (batchGenerationRunning) {
+        if (!batchArrivalPending) batchArrivalPending = loadGenerator.next(nextBatchArrival);
+        if (batchArrivalPending) return nextBatchArrival.tick;
+    }
+    return std::numeric_limits<uint64_t>::max();
+}
 
-            if (!stillRunning || process->isFinished) {
-                processRunning = false;
-            } else if (config.getScheduler() == "rr") {
-                process->remainingQuantum--;
-                if (process->remainingQuantum <= 0 && !process->isSleeping) {
-                    bool shouldPreempt = false;
-                    {
-                        std::lock_guard<std::mutex> lock(schedulerMutex);
-                        shouldPreempt = !readyQueue.empty();
-                    }
-
-                    if (shouldPreempt) {
-                        {
-                            std::lock_guard<std::mutex> lock(schedulerMutex);
-                            readyQueue.push(process);
-                        }
-                        cv.notify_one();
-                        processRunning = false;
-                    } else {
-                        process->remainingQuantum = config.getQuantumCycles();
-                    }
-                }
-            }
+void CPUScheduler::admitDue() {
+    std::vector<Admission> due;
+    std::vector<RunEvent> recorded;
+    std::vector<Arrival> arrivals;
+    {
+        std::lock_guard<std::mutex> lock(schedulerMutex);
+        uint64_t now = clock.now();
 
-            if (config.getDelaysPerExec() > 0) {
-                std::this_thread::sleep_for(std::chrono::milliseconds(config.getDelaysPerExec() * 10));
-            } else {
-             //   std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        while (!pendingAdmissions.empty()) {
+            due.push_back(std::move(pendingAdmissions.front()));
+            pendingAdmissions.pop_front();
+        }
+
+        if (replaying) {
+            RunEvent event;
+            while (replayer.nextArrivalDue(now, event)) recorded.push_back(std::move(event));
+        } else {
+            while (nextArrivalTickLocked() <= now && batchArrivalPending) {
+                arrivals.push_back(nextBatchArrival);
+                batchArrivalPending = false;
             }
         }
+    }
+
+    // Processes are built outside the lock, in arrival order
+    for (const RunEvent& event : recorded) {
+        due.push_back(fromRecorded(event));
+    }
+    for (const Arrival& arrival : arrivals) {
+        Admission admission;
+        admission.quiet = true;
+        admission.insOverride = arrival.instructions;
+        int pid = static_cast<int>(processCounter++);
+        admission.process = workload.build("p" + std::to_string(pid), pid, arrival.memSize, arrival.instructions);
+        due.push_back(std::move(admission));
+    }
+
+    for (Admission& admission : due) {
+        admit(admission);
+    }
+}
+
+CPUScheduler::Admission CPUScheduler::fromRecorded(const RunEvent& event) {
+    Admission admission;
+    admission.quiet = true;
+    admission.source = event.source;
+    if (event.source.empty()) {
+        admission.insOverride = static_cast<int>(event.b);
+        admission.process = workload.build(event.name, event.pid, static_cast<int>(event.a), admission.insOverride);
+    } else {
+        admission.allocate = false;
+        admission.process = ProcessPool::make(event.name, event.pid, static_cast<int>(event.a));
+        std::string error;
+        ProgramPtr program = programCache.compile(event.source, error);
+        if (program) {
+            admission.process->setProgram(std::move(program));
+        } else {
+            admission.process->parseUserInstructions(event.source); // recorded before the statement limit
+        }
+    }
+
+    // Keep later console submissions from reusing recorded pids
+    uint64_t next = static_cast<uint64_t>(event.pid) + 1;
+    uint64_t current = processCounter;
+    while (current < next && !processCounter.compare_exchange_weak(current, next)) {}
+    return admission;
+}
+
+void CPUScheduler::emitRunEvent(RunEventType type, int core, int pid, int64_t a, int64_t b,
+                                const std::string& name, const std::string& source) {
+    RunEvent event;
+    event.type = type;
+    event.tick = clock.now();
+    event.core = core;
+    event.pid = pid;
+    event.a = a;
+    event.b = b;
+    event.name = name;
+    event.source = source;
+
+    if (recorder.isActive()) {
+        recorder.record(event);
+    }
+    if (replaying) {
+        replayer.check(event);
+        if (replayer.isComplete()) finishReplay();
+    }
+}
+
+void CPUScheduler::onPageEvent(bool pageIn, int pid, int page, int frame) {
+    if (tracer.isEnabled()) {
+        tracer.record(pageIn ? TraceEventType::PageFault : TraceEventType::Eviction, clock.now(), -1, pid, page);
+    }
+    if (tracing) {
+        emitRunEvent(pageIn ? RunEventType::PageIn : RunEventType::PageOut, -1, pid, page, frame);
+    }
+}
+
+// Called on the worker once the replay has matched or diverged
+void CPUScheduler::finishReplay() {
+    {
+        std::lock_guard<std::mutex> lock(schedulerMutex);
+        replaying = false;
+        replayDone = true;
+        tracing = recorder.isActive();
+    }
+    cv.notify_all();
+}
+
+void CPUScheduler::startTracing() {
+    if (tracer.isEnabled()) {
+        std::cout << "Tracing is already running." << std::endl;
+        return;
+    }
+    tracer.start(config.getNumCpu());
+
+    // Open a slice for whatever is already on a core so the timeline starts consistent
+    {
+        std::lock_guard<std::mutex> lock(schedulerMutex);
+        uint64_t now = clock.now();
+        for (const auto& process : runningProcesses) {
+            tracer.nameProcess(process->pid, process->name);
+            tracer.record(TraceEventType::Dispatch, now, process->assignedCore, process->pid);
+        }
+        std::queue<ProcessPtr> tempQueue = readyQueue;
+        while (!tempQueue.empty()) {
+            tracer.nameProcess(tempQueue.front()->pid, tempQueue.front()->name);
+            tempQueue.pop();
+        }
+    }
+    std::cout << "Tracing core activity." << std::endl;
+}
+
+void CPUScheduler::stopTracing(const std::string& filename) {
+    if (!tracer.isEnabled()) {
+        std::cout << "Tracing is not running." << std::endl;
+        return;
+    }
+    tracer.stop();
+    size_t count = tracer.exportChromeTrace(filename);
+    std::cout << "Wrote " << count << " trace events to " << filename << ".";
+    if (uint64_t dropped = tracer.getDropped()) {
+        std::cout << " (" << dropped << " dropped: per-thread buffer full)";
+    }
+    std::cout << std::endl;
+}
+
+bool CPUScheduler::startMetrics(const std::string& filename, uint64_t interval) {
+    if (metrics.isEnabled()) {
+        std::cout << "Metrics are already being written to " << metrics.getFilename() << "." << std::endl;
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(schedulerMutex);
+        lastPageIns = memoryManager.getPageIns();
+        lastPageOuts = memoryManager.getPageOuts();
+    }
+    if (!metrics.start(filename, interval, clock.now())) {
+        std::cout << "Error: Could not create " << filename << std::endl;
+        return false;
+    }
+    std::cout << "Sampling metrics every " << interval << " ticks to " << filename << "." << std::endl;
+    return true;
+}
+
+void CPUScheduler::stopMetrics() {
+    if (!metrics.isEnabled()) {
+        std::cout << "Metrics sampling is not running." << std::endl;
+        return;
+    }
+    metrics.stop();
+    uint64_t rows = metrics.getRows();
+    std::cout << "Wrote " << rows << " samples to " << metrics.getFilename() << " (avg "
+              << (rows ? metrics.getCaptureNanos() / rows : 0) << " ns per sample on the cores";
+    if (uint64_t dropped = metrics.getDropped()) {
+        std::cout << ", " << dropped << " dropped: writer fell behind";
+    }
+    std::cout << ")." << std::endl;
+}
+
+// Called by the core that claimed a sample boundary; a handful of counter
+// reads under the lock, file I/O happens on the sampler's writer thread.
+void CPUScheduler::sampleMetrics(uint64_t tick) {
+    auto start = std::chrono::steady_clock::now();
+    MetricsSample sample;
+    sample.tick = tick;
+    sample.readyQueue = readyCount;
+    {
+        std::lock_guard<std::mutex> lock(schedulerMutex);
+        int pageIns = memoryManager.getPageIns();
+        int pageOuts = memoryManager.getPageOuts();
+        sample.usedMemory = memoryManager.getUsedMemory();
+        sample.freeFrames = memoryManager.getFreeFrames();
+        sample.pageIns = pageIns - lastPageIns;
+        sample.pageOuts = pageOuts - lastPageOuts;
+        sample.activeCores = runningProcesses.size();
+        sample.finished = finishedArchive.totalArchived();
+        lastPageIns = pageIns;
+        lastPageOuts = pageOuts;
+    }
+    metrics.push(sample, std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+}
+
+bool CPUScheduler::startRecording(const std::string& filename) {
+    if (initialized) {
+        std::cout << "record-start must be issued before initialize so the whole run is captured." << std::endl;
+        return false;
+    }
+    // Fail now rather than at initialize; append mode leaves an existing file intact
+    if (!std::ofstream(filename, std::ios::binary | std::ios::app).is_open()) {
+        std::cout << "Error: Could not create " << filename << "." << std::endl;
+        return false;
+    }
+    recordFile = filename;
+    std::cout << "Recording to " << filename << " once the scheduler is initialized (deterministic mode)." << std::endl;
+    return true;
+}
+
+bool CPUScheduler::stopRecording() {
+    if (!recorder.isActive()) {
+        if (!recordFile.empty()) {
+            recordFile.clear();
+            std::cout << "Recording disarmed." << std::endl;
+            return true;
+        }
+        std::cout << "No recording in progress." << std::endl;
+        return false;
+    }
+    tracing = replaying.load();
+    size_t count = recorder.stop();
+    std::cout << "Recorded " << count << " events to " << recordFile << "." << std::endl;
+    recordFile.clear();
+    return true;
+}
+
+RunHeader CPUScheduler::configHeader(uint64_t seed) const {
+    RunHeader header;
+    header.seed = seed;
+    header.numCpu = config.getNumCpu();
+    header.scheduler = config.getScheduler();
+    header.quantumCycles = config.getQuantumCycles();
+    header.delaysPerExec = config.getDelaysPerExec();
+    header.maxOverallMem = config.getMaxOverallMem();
+    header.memPerFrame = config.getMemPerFrame();
+    return header;
+}
+
+// Settings a recorded run or checkpoint only makes sense under
+bool CPUScheduler::matchesConfig(const RunHeader& header, const char* what) const {
+    auto mismatch = [what](const char* key, const auto& recorded, const auto& current) {
+        if (recorded == current) return false;
+        std::cout << "Error: " << what << " with " << key << " " << recorded
+                  << " but config.txt has " << current << "." << std::endl;
+        return true;
+    };
+    return !(mismatch("num-cpu", header.numCpu, config.getNumCpu()) ||
+             mismatch("scheduler", header.scheduler, config.getScheduler()) ||
+             mismatch("quantum-cycles", header.quantumCycles, static_cast<uint64_t>(config.getQuantumCycles())) ||
+             mismatch("delays-per-exec", header.delaysPerExec, static_cast<uint64_t>(config.getDelaysPerExec())) ||
+             mismatch("max-overall-mem", header.maxOverallMem, static_cast<uint64_t>(config.getMaxOverallMem())) ||
+             mismatch("mem-per-frame", header.memPerFrame, static_cast<uint64_t>(config.getMemPerFrame())));
+}
+
+bool CPUScheduler::replay(const std::string& filename) {
+    if (initialized) {
+        std::cout << "replay must be run before initialize." << std::endl;
+        return false;
+    }
+    if (!config.loadFromFile()) {
+        std::cout << "Error: Could not load config.txt" << std::endl;
+        return false;
+    }
+    if (!replayer.load(filename)) {
+        return false;
+    }
+
+    const RunHeader& header = replayer.getHeader();
+    if (!matchesConfig(header, "trace was recorded")) {
+        return false;
+    }
+
+    std::cout << "Replaying " << replayer.total() << " events from " << filename << "..." << std::endl;
+    replayDone = false;
+    replaying = true;
+    if (!start(header.seed, true)) {
+        replaying = false;
+        return false;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(schedulerMutex);
+        cv.wait(lock, [this] { return replayDone || !schedulerRunning; });
+    }
+
+    if (replayer.hasDiverged()) {
+        std::cout << "Replay diverged at " << replayer.getDivergence() << std::endl;
+        return false;
+    }
+    std::cout << "Replay matched all " << replayer.matched() << " recorded events." << std::endl;
+    return true;
+}
+
+namespace {
+
+// Leading fields of the checkpoint's Meta section: what restore checks before starting
+void writeMetaHeader(BinaryWriter& meta, const RunHeader& header, bool deterministic, bool batchRunning) {
+    meta.u64(header.seed);
+    meta.varint(header.numCpu);
+    meta.str(header.scheduler);
+    meta.varint(header.quantumCycles);
+    meta.varint(header.delaysPerExec);
+    meta.varint(header.maxOverallMem);
+    meta.varint(header.memPerFrame);
+    meta.u8(deterministic);
+    meta.u8(batchRunning);
+}
+
+void readMetaHeader(BinaryReader& meta, RunHeader& header, bool& deterministic, bool& batchRunning) {
+    header.seed = meta.u64();
+    header.numCpu = static_cast<int>(meta.varint());
+    header.scheduler = std::string(meta.str());
+    header.quantumCycles = meta.varint();
+    header.delaysPerExec = meta.varint();
+    header.maxOverallMem = meta.varint();
+    header.memPerFrame = meta.varint();
+    deterministic = meta.u8() != 0;
+    batchRunning = meta.u8() != 0;
+}
+
+} // namespace
+
+bool CPUScheduler::checkpoint(const std::string& filename) {
+    if (!initialized) {
+        std::cout << "Please initialize the scheduler first." << std::endl;
+        return false;
+    }
+
+    checkpoint::Writer writer;
+    size_t processes;
+    auto pauseStart = std::chrono::steady_clock::now();
+    pauseWorkers();
+    {
+        std::lock_guard<std::mutex> lock(schedulerMutex);
+        processes = saveStateLocked(writer);
+    }
+    resumeWorkers();
+    auto paused = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - pauseStart);
+
+    if (!writer.save(filename)) {
+        std::cout << "Error: Could not write " << filename << std::endl;
+        return false;
+    }
+    std::cout << "Checkpoint of " << processes << " live processes written to " << filename
+              << " (cores paused " << paused.count() / 1000.0 << " ms)." << std::endl;
+    return true;
+}
+
+bool CPUScheduler::restore(const std::string& filename) {
+    if (initialized) {
+        std::cout << "restore must be run before initialize." << std::endl;
+        return false;
+    }
+    if (!recordFile.empty()) {
+        std::cout << "A restored run can't be recorded; the trace would not start at tick 0." << std::endl;
+        return false;
+    }
+    if (!config.loadFromFile()) {
+        std::cout << "Error: Could not load config.txt" << std::endl;
+        return false;
+    }
+
+    auto loadStart = std::chrono::steady_clock::now();
+    checkpoint::File file;
+    std::string error;
+    if (!file.open(filename, error)) {
+        std::cout << "Error: " << error << std::endl;
+        return false;
+    }
+
+    BinaryReader meta = file.section(checkpoint::Section::Meta);
+    RunHeader header;
+    bool deterministicRun;
+    bool batchRunning;
+    readMetaHeader(meta, header, deterministicRun, batchRunning);
+    if (meta.failed()) {
+        std::cout << "Error: " << filename << " has no scheduler state." << std::endl;
+        return false;
+    }
+    if (!matchesConfig(header, "checkpoint was taken")) {
+        return false;
+    }
+
+    if (!start(header.seed, deterministicRun, &file)) {
+        return false;
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - loadStart);
+    size_t live;
+    {
+        std::lock_guard<std::mutex> lock(schedulerMutex);
+        live = liveByPid.size();
+    }
+    std::cout << "Restored " << live << " live processes at tick " << clock.now() << " from "
+              << filename << " (" << file.size() / 1024 << " KB in " << elapsed.count() / 1000.0 << " ms)." << std::endl;
+
+    // Deterministic runs resume their arrival stream in loadState
+    if (batchRunning && !deterministic) {
+        startBatchGeneration();
+    }
+    return true;
+}
+
+// Asks every worker to park at the top of its loop and waits until they have
+void CPUScheduler::pauseWorkers() {
+    std::unique_lock<std::mutex> lock(schedulerMutex);
+    pauseRequested = true;
+    cv.notify_all();
+    pauseCv.wait(lock, [this] { return pausedWorkers == workerThreads.size() || !schedulerRunning; });
+}
+
+void CPUScheduler::resumeWorkers() {
+    {
+        std::lock_guard<std::mutex> lock(schedulerMutex);
+        pauseRequested = false;
+    }
+    cv.notify_all();
+}
+
+void CPUScheduler::parkWorker() {
+    std::unique_lock<std::mutex> lock(schedulerMutex);
+    pausedWorkers++;
+    pauseCv.notify_all();
+    cv.wait(lock, [this] { return !pauseRequested || !schedulerRunning; });
+    pausedWorkers--;
+}
+
+// Requires schedulerMutex and parked workers. Returns the number of live processes.
+size_t CPUScheduler::saveStateLocked(checkpoint::Writer& writer) const {
+    using checkpoint::Section;
+
+    BinaryWriter& meta = writer.section(Section::Meta);
+    writeMetaHeader(meta, configHeader(workload.getSeed()), deterministic, batchGenerationRunning);
+    meta.u64(clock.now());
+    meta.u64(processCounter);
+    meta.u64(activeCpuTicks);
+    meta.u64(idleCpuTicks);
+    meta.u64(currentQuantumCycle);
+    meta.varint(static_cast<uint64_t>(quantumCycleCount.load()));
+
+    memoryManager.saveState(writer.section(Section::Memory));
+
+    enum Place : uint8_t { Ready = 0, Running = 1, Pending = 2 };
+    BinaryWriter& processes = writer.section(Section::Processes);
+    size_t count = 0;
+    for (const SimCore& core : cores) count += core.process != nullptr;
+    count += readyQueue.size() + pendingAdmissions.size();
+    processes.varint(count);
+
+    for (const SimCore& core : cores) {
+        if (!core.process) continue;
+        processes.u8(Running);
+        processes.varint(static_cast<uint64_t>(core.id));
+        processes.varint(core.stall);
+        checkpoint::writeProcess(processes, *core.process);
+    }
+    std::queue<ProcessPtr> ready = readyQueue;
+    while (!ready.empty()) {
+        processes.u8(Ready);
+        checkpoint::writeProcess(processes, *ready.front());
+        ready.pop();
+    }
+    for (const Admission& admission : pendingAdmissions) {
+        processes.u8(Pending);
+        processes.str(admission.source);
+        processes.svarint(admission.insOverride);
+        processes.u8(admission.allocate);
+        processes.u8(admission.quiet);
+        checkpoint::writeProcess(processes, *admission.process);
+    }
+
+    BinaryWriter& archive = writer.section(Section::Archive);
+    archive.varint(finishedArchive.totalArchived());
+    archive.varint(finishedArchive.size());
+    for (size_t i = 0; i < finishedArchive.size(); ++i) {
+        checkpoint::writeSummary(archive, finishedArchive.at(i));
+    }
+
+    BinaryWriter& histograms = writer.section(Section::Latency);
+    latency.response.save(histograms);
+    latency.waiting.save(histograms);
+    latency.turnaround.save(histograms);
+    latency.readyQueue.save(histograms);
+
+    // Only the deterministic worker draws arrivals under the lock; a free-running
+    // batch generator simply starts a fresh stream after restore
+    if (deterministic && batchGenerationRunning) {
+        BinaryWriter& arrivals = writer.section(Section::Arrivals);
+        loadGenerator.saveState(arrivals);
+        arrivals.u8(batchArrivalPending);
+        arrivals.u64(nextBatchArrival.tick);
+        arrivals.svarint(nextBatchArrival.memSize);
+        arrivals.svarint(nextBatchArrival.instructions);
+    }
+    return count;
+}
+
+// Undoes a partial loadState(), so a failed restore leaves nothing behind for
+// the next initialize. No worker exists yet.
+void CPUScheduler::discardRunState() {
+    {
+        std::lock_guard<std::mutex> lock(schedulerMutex);
+        readyQueue = {};
+        readyCount = 0;
+        runningProcesses.clear();
+        liveByName.clear();
+        liveByPid.clear();
+        pendingAdmissions.clear();
+        batchArrivalPending = false;
+    }
+    batchGenerationRunning = false;
+    cores.clear();
+    memoryManager.init(config.getMaxOverallMem(), config.getMemPerFrame(), config.getMaxMemPerProc());
+    finishedArchive.reset(config.getFinishedArchiveSize());
+    latency.response.reset();
+    latency.waiting.reset();
+    latency.turnaround.reset();
+    latency.readyQueue.reset();
+    clock.reset();
+    processCounter = 1;
+    activeCpuTicks = 0;
+    idleCpuTicks = 0;
+    currentQuantumCycle = 0;
+    quantumCycleCount = 0;
+}
+
+// Runs inside start(), after the subsystems are configured and before any worker exists
+bool CPUScheduler::loadState(const checkpoint::File& file, std::string& error) {
+    using checkpoint::Section;
+
+    BinaryReader meta = file.section(Section::Meta);
+    RunHeader header;
+    bool deterministicRun;
+    bool batchRunning;
+    readMetaHeader(meta, header, deterministicRun, batchRunning);
+    uint64_t ticks = meta.u64();
+    processCounter = meta.u64();
+    activeCpuTicks = meta.u64();
+    idleCpuTicks = meta.u64();
+    currentQuantumCycle = meta.u64();
+    quantumCycleCount = static_cast<int>(meta.varint());
+    if (meta.failed()) {
+        error = "truncated scheduler state";
+        return false;
+    }
+    clock.advance(ticks);
+
+    BinaryReader memory = file.section(Section::Memory);
+    if (!memoryManager.loadState(memory)) {
+        error = "memory state does not match max-overall-mem / mem-per-frame";
+        return false;
+    }
+
+    BinaryReader processes = file.section(Section::Processes);
+    uint64_t count = processes.varint();
+    std::lock_guard<std::mutex> lock(schedulerMutex);
+    for (uint64_t i = 0; i < count; ++i) {
+        uint8_t place = processes.u8();
+        uint64_t coreId = 0;
+        uint64_t stall = 0;
+        Admission admission;
+        if (place == 1) {
+            coreId = processes.varint();
+            stall = processes.varint();
+        } else if (place == 2) {
+            admission.source = std::string(processes.str());
+            admission.insOverride = static_cast<int>(processes.svarint());
+            admission.allocate = processes.u8() != 0;
+            admission.quiet = processes.u8() != 0;
+        }
+
+        ProcessPtr process = checkpoint::readProcess(processes);
+        if (!process || place > 2 || (place == 1 && (coreId >= cores.size() || cores[coreId].process))) {
+            error = "corrupt process record " + std::to_string(i);
+            return false;
+        }
+        registerLocked(process);
+        if (place == 1) {
+            cores[coreId].process = process;
+            cores[coreId].stall = static_cast<unsigned long>(stall);
+            runningProcesses.push_back(process);
+        } else if (place == 0) {
+            readyQueue.push(process);
+            readyCount++;
+        } else {
+            admission.process = std::move(process);
+            pendingAdmissions.push_back(std::move(admission));
+        }
+    }
+
+    BinaryReader archive = file.section(Section::Archive);
+    uint64_t archived = archive.varint();
+    uint64_t kept = archive.varint();
+    for (uint64_t i = 0; i < kept; ++i) {
+        ProcessSummary summary;
+        if (!checkpoint::readSummary(archive, summary)) {
+            error = "corrupt finished-process record " + std::to_string(i);
+            return false;
+        }
+        finishedArchive.add(std::move(summary));
+    }
+    finishedArchive.setTotalArchived(static_cast<size_t>(archived));
 
+    BinaryReader histograms = file.section(Section::Latency);
+    if (!latency.response.load(histograms) || !latency.waiting.load(histograms) ||
+        !latency.turnaround.load(histograms) || !latency.readyQueue.load(histograms)) {
+        error = "corrupt latency histograms";
+        return false;
+    }
+
+    if (deterministic && batchRunning) {
+        BinaryReader arrivals = file.section(Section::Arrivals);
+        if (!loadGenerator.configure(config, workload.getSeed()) || !loadGenerator.loadState(arrivals)) {
+            error = "could not resume the batch arrival stream";
+            return false;
+        }
+        batchArrivalPending = arrivals.u8() != 0;
+        nextBatchArrival.tick = arrivals.u64();
+        nextBatchArrival.memSize = static_cast<int>(arrivals.svarint());
+        nextBatchArrival.instructions = static_cast<int>(arrivals.svarint());
+        if (arrivals.failed()) {
+            error = "truncated batch arrival state";
+            return false;
+        }
+        batchGenerationRunning = true;
+    }
+    return !processes.failed();
+}
+
+// Runs one CPU cycle on a simulated core. Returns true if an instruction was executed.
+bool CPUScheduler::stepCore(SimCore& core, CorePacer::Clock::time_point now) {
+    if (!core.process) {
+        if (readyCount == 0) return false;
         {
             std::lock_guard<std::mutex> lock(schedulerMutex);
-            runningProcesses.erase(
-                std::remove(runningProcesses.begin(), runningProcesses.end(), process),
-                runningProcesses.end());
-            
-            if (process->isFinished) {
-                finishedProcesses.push_back(process);
-                process->assignedCore = -1;
-                memoryManager.deallocate(process); // only free when finished
+            if (readyQueue.empty()) return false;
+            core.process = readyQueue.front();
+            readyQueue.pop();
+            readyCount--;
+            core.process->assignedCore = core.id;
+            core.process->remainingQuantum = config.getQuantumCycles();
+            runningProcesses.push_back(core.process);
+        }
+
+        Process& dispatched = *core.process;
+        dispatched.contextSwitches++;
+        uint64_t tick = clock.now();
+        uint64_t waited = tick - dispatched.readySinceTick;
+        dispatched.readyWaitTicks += waited;
+        latency.readyQueue.record(waited);
+        if (dispatched.firstDispatchTick == Process::noTick) {
+            dispatched.firstDispatchTick = tick;
+            latency.response.record(tick - dispatched.arrivalTick);
+        }
+        if (tracer.isEnabled()) tracer.record(TraceEventType::Dispatch, clock.now(), core.id, core.process->pid);
+        if (tracing) emitRunEvent(RunEventType::Dispatch, core.id, core.process->pid);
+    }
+
+    // Memory is already allocated in addProcess()/batchGenerator()
+    ProcessPtr& process = core.process;
+
+    activeCpuTicks++;
+    process->cpuTicks++;
+    if (process->isSleeping) process->sleepTicks++;
+    bool stillRunning = process->executeNextInstruction(core.id);
+    checkMemoryDump();
+
+    if (core.pacer.isEnabled()) {
+        core.pacer.onExecuted(now);
+    }
+
+    if (!stillRunning || process->isFinished) {
+        releaseCore(core);
+    } else if (config.getScheduler() == "rr") {
+        process->remainingQuantum--;
+        if (process->remainingQuantum <= 0 && !process->isSleeping) {
+            if (tracer.isEnabled()) tracer.record(TraceEventType::QuantumExpiry, clock.now(), core.id, process->pid);
+            if (readyCount > 0) {
+                ProcessPtr preempted = process;
+                preempted->preemptTicks.push_back(clock.now());
+                if (tracer.isEnabled()) tracer.record(TraceEventType::Preempt, clock.now(), core.id, preempted->pid);
+                if (tracing) emitRunEvent(RunEventType::Preempt, core.id, preempted->pid);
+                releaseCore(core);
+                enqueueReady(preempted);
+            } else {
+                process->remainingQuantum = config.getQuantumCycles();
             }
         }
     }
+    return true;
+}
+
+void CPUScheduler::releaseCore(SimCore& core) {
+    ProcessPtr process = std::move(core.process);
+    core.process.reset();
+
+    if (process->isFinished) {
+        process->finishTick = clock.now();
+        latency.turnaround.record(process->finishTick - process->arrivalTick);
+        latency.waiting.record(process->readyWaitTicks);
+    }
+
+    if (process->isFinished && (tracing || tracer.isEnabled())) {
+        ExitReason reason = ProcessSummary(*process).exitReason;
+        tracer.record(TraceEventType::Finish, clock.now(), core.id, process->pid, static_cast<int32_t>(reason));
+        if (tracing) emitRunEvent(RunEventType::Finish, core.id, process->pid, static_cast<int64_t>(reason));
+    }
+
+    std::lock_guard<std::mutex> lock(schedulerMutex);
+    runningProcesses.erase(
+        std::remove(runningProcesses.begin(), runningProcesses.end(), process),
+        runningProcesses.end());
+
+    if (process->isFinished) {
+        process->assignedCore = -1;
+        // Keep only the summary; the Process itself goes once the last reference drops.
+        // Taken before deallocating so the page counters are still there.
+        ProcessSummary summary = summarizeLocked(process);
+        summary.residentBytes = 0;
+        summary.memoryAllocated = false;
+        memoryManager.deallocate(process); // only free when finished
+        finishedArchive.add(std::move(summary));
+        unregisterLocked(process);
+    }
+}
+
+// Memory dump once per quantum of CPU ticks, whichever core crosses it first
+void CPUScheduler::checkMemoryDump() {
+    uint64_t newQuantumCycle = clock.now() / config.getQuantumCycles();
+    uint64_t seen = currentQuantumCycle;
+    if (newQuantumCycle > seen && currentQuantumCycle.compare_exchange_strong(seen, newQuantumCycle)) {
+        int dump = ++quantumCycleCount;
+        tracer.record(TraceEventType::MemoryDump, clock.now(), -1, -1, dump);
+        memoryManager.dumpStatusToFile(dump);
+    }
 }
 
 
@@ -433,9 +1470,10 @@ void CPUScheduler::printVmstat() const {
     const auto totalMem   = memoryManager.getTotalMemory();
     const auto usedMem    = memoryManager.getUsedMemory();
     const auto freeMem    = memoryManager.getFreeMemory();
-    const auto totalTicks = cpuTicks.load();
+    const auto totalTicks = clock.now();
     const auto active     = activeCpuTicks.load();
     const auto idle       = totalTicks - active;
+    const double elapsed  = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
 
     const int pageIns  = memoryManager.getPageIns();   // NEW
     const int pageOuts = memoryManager.getPageOuts();  // NEW
@@ -447,10 +1485,28 @@ void CPUScheduler::printVmstat() const {
 
     std::cout << std::left << std::setw(20) << "Idle CPU ticks:"    << idle     << "\n";
     std::cout << std::left << std::setw(20) << "Active CPU ticks:"  << active   << "\n";
-    std::cout << std::left << std::setw(20) << "Total CPU ticks:"   << totalTicks << "\n\n";
+    std::cout << std::left << std::setw(20) << "Total CPU ticks:"   << totalTicks << "\n";
+    std::cout << std::left << std::setw(20) << "Instructions/sec:"  << std::fixed << std::setprecision(1)
+              << (elapsed > 0.0 ? active / elapsed : 0.0) << "\n\n";
 
     std::cout << std::left << std::setw(20) << "Num paged in:"      << pageIns << "\n";
-    std::cout << std::left << std::setw(20) << "Num paged out:"     << pageOuts << "\n";
+    std::cout << std::left << std::setw(20) << "Num paged out:"     << pageOuts << "\n\n";
+
+    // Process address spaces only hold the pages that have been written
+    const SparseMemory::Stats processMemory = SparseMemory::getStats();
+    std::cout << std::left << std::setw(20) << "Process memory:"    << processMemory.reserved << " bytes\n";
+    std::cout << std::left << std::setw(20) << "Pages resident:"    << processMemory.resident << " bytes\n";
+    std::cout << std::left << std::setw(20) << "Saved by sparsity:" << processMemory.reserved - processMemory.resident
+              << " bytes\n";
+    const ProcessPool::Stats pool = ProcessPool::getStats();
+    std::cout << std::left << std::setw(20) << "Process slabs:"     << pool.slabs << " (" << pool.live << " blocks live, "
+              << pool.recycled << " reused)\n\n";
+
+    const ProgramCache::Stats cache = programCache.getStats();
+    std::cout << std::left << std::setw(20) << "Program cache:"     << cache.entries << " / " << cache.capacity << " programs\n";
+    std::cout << std::left << std::setw(20) << "Cache hits:"        << cache.hits << "\n";
+    std::cout << std::left << std::setw(20) << "Cache misses:"      << cache.misses << "\n";
+    std::cout << std::left << std::setw(20) << "Cache evictions:"   << cache.evictions << "\n";
 
     std::cout << "\n======================\n";
 
@@ -462,7 +1518,6 @@ std::vector<ProcessPtr> CPUScheduler::listAllProcesses() {
     std::vector<ProcessPtr> all;
 
     all.insert(all.end(), runningProcesses.begin(), runningProcesses.end());
-    all.insert(all.end(), finishedProcesses.begin(), finishedProcesses.end());
 
     std::queue<ProcessPtr> tempQueue = readyQueue;
     while (!tempQueue.empty()) {
@@ -476,123 +1531,174 @@ std::vector<ProcessPtr> CPUScheduler::listAllProcesses() {
 
 
 
-void CPUScheduler::printProcessSMI() {
-    std::lock_guard<std::mutex> lock(schedulerMutex);
+namespace {
+
+// process-smi sort columns; larger values first, except pid and name
+using SummaryLess = bool (*)(const ProcessSummary&, const ProcessSummary&);
+
+SummaryLess processSortOrder(const std::string& key) {
+    if (key == "pid")     return [](const ProcessSummary& a, const ProcessSummary& b) { return a.pid < b.pid; };
+    if (key == "name")    return [](const ProcessSummary& a, const ProcessSummary& b) { return a.name < b.name; };
+    if (key == "cpu")     return [](const ProcessSummary& a, const ProcessSummary& b) { return a.cpuTicks > b.cpuTicks; };
+    if (key == "sleep")   return [](const ProcessSummary& a, const ProcessSummary& b) { return a.sleepTicks > b.sleepTicks; };
+    if (key == "ctxsw")   return [](const ProcessSummary& a, const ProcessSummary& b) { return a.contextSwitches > b.contextSwitches; };
+    if (key == "preempt") return [](const ProcessSummary& a, const ProcessSummary& b) { return a.preemptions > b.preemptions; };
+    if (key == "faults")  return [](const ProcessSummary& a, const ProcessSummary& b) { return a.pageFaults > b.pageFaults; };
+    if (key == "evict")   return [](const ProcessSummary& a, const ProcessSummary& b) { return a.evictions > b.evictions; };
+    if (key == "rss")     return [](const ProcessSummary& a, const ProcessSummary& b) { return a.residentBytes > b.residentBytes; };
+    return nullptr;
+}
+
+} // namespace
+
+bool CPUScheduler::isProcessSortKey(const std::string& key) {
+    return processSortOrder(key) != nullptr;
+}
+
+void CPUScheduler::printProcessSMI(const std::string& sortKey, size_t topN) {
+    // Finished processes: last 5 only to avoid clutter
+    SchedulerSnapshot snap = takeSnapshot(true, 5);
     
-    std::cout << "+-----------------------------------------------------------------------------+\n";
-    std::cout << "|                          Process Memory Management                          |\n";
-    std::cout << "+-------------------------------+----------------------+----------------------+\n";
+    std::cout << "+-------------------------------------------------------------------------------------------------------+\n";
+    std::cout << "|                                       Process Memory Management                                       |\n";
+    std::cout << "+-------------------------------------------------------------------------------------------------------+\n";
 
-    size_t totalMem = memoryManager.getTotalMemory();       // in bytes
-    size_t usedMem = memoryManager.getUsedMemory();         // in bytes
+    size_t totalMem = snap.totalMemory;       // in bytes
+    size_t usedMem = snap.usedMemory;         // in bytes
     size_t freeMem = totalMem - usedMem;
 
     std::cout << "| Total Memory: " << std::setw(8) << totalMem
               << " B | Used Memory: " << std::setw(8) << usedMem
-              << " B | Free Memory: " << std::setw(8) << freeMem << " B |\n";
-
-    std::cout << "+-------------------------------+----------------------+----------------------+\n";
-    std::cout << "| PID  | Process Name   | Pages | Mem Usage (B) | Status    | Start Time     |\n";
-    std::cout << "|------|----------------|-------|---------------|-----------|----------------|\n";
-
-    // Helper lambda to calculate pages for a process
-    auto calculatePages = [this](int memSize) -> int {
-        int frameSize = memoryManager.getMemPerFrame();
-        return (memSize + frameSize - 1) / frameSize;
+              << " B | Free Memory: " << std::setw(8) << freeMem << " B\n";
+
+    // Live processes ranked like top; only the shown rows are fully ordered
+    std::vector<std::pair<ProcessSummary, const char*>> live;
+    live.reserve(snap.running.size() + snap.waiting.size());
+    for (auto& process : snap.running) live.emplace_back(std::move(process), "Running");
+    for (auto& process : snap.waiting) live.emplace_back(std::move(process), "Waiting");
+
+    SummaryLess less = processSortOrder(sortKey);
+    const char* sortedBy = less ? sortKey.c_str() : "cpu";
+    if (!less) less = processSortOrder("cpu");
+    auto byKey = [less](const auto& a, const auto& b) { return less(a.first, b.first); };
+    size_t shown = (topN == 0 || topN > live.size()) ? live.size() : topN;
+    std::partial_sort(live.begin(), live.begin() + shown, live.end(), byKey);
+
+    std::cout << "+------+----------------+----------+------+--------+--------+-------+---------+--------+-------+--------+\n";
+    std::cout << "| PID  | Process Name   | Status   | Core | CPU    | Sleep  | CtxSw | Preempt | Faults | Evict | RSS (B)|\n";
+    std::cout << "|------|----------------|----------|------|--------|--------|-------|---------|--------|-------|--------|\n";
+
+    auto printProcessRow = [](const ProcessSummary& process, const std::string& status) {
+        std::cout << "| " << std::right << std::setw(4) << process.pid
+                  << " | " << std::setw(14) << std::left << process.name.substr(0, 14)
+                  << " | " << std::setw(8) << status << std::right
+                  << " | " << std::setw(4);
+        if (status == "Running") std::cout << process.assignedCore;
+        else std::cout << "-";
+        std::cout << " | " << std::setw(6) << process.cpuTicks
+                  << " | " << std::setw(6) << process.sleepTicks
+                  << " | " << std::setw(5) << process.contextSwitches
+                  << " | " << std::setw(7) << process.preemptions
+                  << " | " << std::setw(6) << process.pageFaults
+                  << " | " << std::setw(5) << process.evictions
+                  << " | " << std::setw(6) << process.residentBytes << " |\n";
     };
 
-    // Helper lambda to format process row
-    auto printProcessRow = [&](const ProcessPtr& process, const std::string& status) {
-        int pages = calculatePages(process->memorySize);
-        bool isAllocated = memoryManager.isAllocated(process);
-        int actualMemUsage = isAllocated ? process->memorySize : 0;
-        
-        std::cout << "| " << std::setw(4) << process->pid 
-                  << " | " << std::setw(14) << std::left << process->name 
-                  << " | " << std::setw(5) << std::right << pages
-                  << " | " << std::setw(13) << actualMemUsage
-                  << " | " << std::setw(9) << std::left << status
-                  << " | " << std::setw(14) << process->creationTime << " |\n";
-    };
-
-    // Count processes by status
-    int runningCount = 0, waitingCount = 0, finishedCount = 0;
-    int totalMemAllocated = 0;
-
-    // Print running processes
-    for (const auto& process : runningProcesses) {
-        std::string status = "Running";
-        if (memoryManager.isAllocated(process)) {
-            status += "*";  // * indicates process has memory allocated
-            totalMemAllocated += process->memorySize;
-        }
-        printProcessRow(process, status);
-        runningCount++;
+    for (size_t i = 0; i < shown; ++i) {
+        printProcessRow(live[i].first, live[i].second);
     }
-
-    // Print processes in ready queue
-    std::queue<ProcessPtr> tempQueue = readyQueue;
-    while (!tempQueue.empty()) {
-        auto process = tempQueue.front();
-        tempQueue.pop();
-        
-        std::string status = "Waiting";
-        if (memoryManager.isAllocated(process)) {
-            status += "*";  // * indicates process has memory allocated
-            totalMemAllocated += process->memorySize;
-        }
-        printProcessRow(process, status);
-        waitingCount++;
+    if (shown < live.size()) {
+        std::cout << "| ...  | (+" << (live.size() - shown) << " more)\n";
     }
-
-    // Print finished processes (last 5 only to avoid clutter)
-    int finishedShown = 0;
-    for (auto it = finishedProcesses.rbegin(); 
-         it != finishedProcesses.rend() && finishedShown < 5; 
-         ++it, ++finishedShown) {
+    for (auto it = snap.finished.rbegin(); it != snap.finished.rend(); ++it) {
         printProcessRow(*it, "Finished");
-        finishedCount++;
-    }
-
-    if (finishedProcesses.size() > 5) {
-        std::cout << "|      | ...            |       |               |           | (+" 
-                  << (finishedProcesses.size() - 5) << " more)      |\n";
     }
 
-    std::cout << "+------+----------------+-------+---------------+-----------+----------------+\n";
+    std::cout << "+------+----------------+----------+------+--------+--------+-------+---------+--------+-------+--------+\n";
     
     // Summary section
-    std::cout << "| Summary:                                                                    |\n";
-    std::cout << "| Running: " << std::setw(3) << runningCount 
-              << " | Waiting: " << std::setw(3) << waitingCount 
-              << " | Finished: " << std::setw(3) << finishedProcesses.size()
-              << " | Total: " << std::setw(3) << (runningCount + waitingCount + finishedProcesses.size()) << "                    |\n";
+    size_t runningCount = snap.running.size();
+    size_t waitingCount = snap.waiting.size();
+    std::cout << "| Running: " << std::setw(6) << runningCount 
+              << " | Waiting: " << std::setw(6) << waitingCount 
+              << " | Finished: " << std::setw(6) << snap.finishedTotal
+              << " | Sorted by: " << sortedBy
+              << " | Shown: " << shown << "\n";
     
     // Memory utilization
     double memUtilization = totalMem > 0 ? (double(usedMem) / totalMem) * 100.0 : 0.0;
+    int totalFrames = snap.totalMemory / snap.memPerFrame;
+    int usedFrames = snap.usedMemory / snap.memPerFrame;
     std::cout << "| Memory Utilization: " << std::fixed << std::setprecision(1) 
-              << std::setw(5) << memUtilization << "%                                          |\n";
-    
-    // Frame information
-    int totalFrames = memoryManager.getTotalMemory() / memoryManager.getMemPerFrame();
-    int usedFrames = memoryManager.getUsedMemory() / memoryManager.getMemPerFrame();
-    std::cout << "| Frames: " << usedFrames << "/" << totalFrames 
-              << " used (" << std::setprecision(1) 
-              << (totalFrames > 0 ? (double(usedFrames) / totalFrames) * 100.0 : 0.0) 
-              << "%)                                        |\n";
-              
-    // Page statistics
-    std::cout << "| Page I/O: " << memoryManager.getPageIns() << " ins, " 
-              << memoryManager.getPageOuts() << " outs                                   |\n";
-    
-    std::cout << "+-----------------------------------------------------------------------------+\n";
-    std::cout << "| Legend: * = Process has memory allocated                                    |\n";
-    std::cout << "+-----------------------------------------------------------------------------+\n";
+              << std::setw(5) << memUtilization << "% | Frames: " << usedFrames << "/" << totalFrames
+              << " | Page I/O: " << snap.pageIns << " ins, " << snap.pageOuts << " outs\n";
+    std::cout << "+-------------------------------------------------------------------------------------------------------+\n";
+    std::cout << "| CPU/Sleep in ticks on a core. Usage: process-smi [-s pid|name|cpu|sleep|ctxsw|preempt|faults|evict|rss] [-n N]\n";
+    std::cout << "+-------------------------------------------------------------------------------------------------------+\n";
+}
+
+void CPUScheduler::writeSummaryJson(std::ostream& out, const ProcessSummary& process, const char* status) {
+    out << "{\"pid\":" << process.pid << ",\"name\":";
+    writeJsonString(out, process.name);
+    out << ",\"status\":\"" << status << "\""
+        << ",\"core\":" << process.assignedCore
+        << ",\"instruction\":" << process.currentInstruction
+        << ",\"instructions\":" << process.totalInstructions
+        << ",\"memory\":" << process.memorySize
+        << ",\"cpu_ticks\":" << process.cpuTicks
+        << ",\"sleep_ticks\":" << process.sleepTicks
+        << ",\"context_switches\":" << process.contextSwitches
+        << ",\"preemptions\":" << process.preemptions
+        << ",\"page_faults\":" << process.pageFaults
+        << ",\"evictions\":" << process.evictions
+        << ",\"rss\":" << process.residentBytes;
+    if (process.exitReason == ExitReason::AccessViolation) {
+        out << ",\"access_violation\":\"0x" << process.invalidAccess << "\"";
+    }
+    out << "}";
+}
+
+bool CPUScheduler::writeProcessJson(std::ostream& out, int pid) const {
+    std::lock_guard<std::mutex> lock(schedulerMutex);
+    auto live = liveByPid.find(pid);
+    if (live != liveByPid.end()) {
+        const ProcessPtr& process = live->second;
+        bool running = std::find(runningProcesses.begin(), runningProcesses.end(), process) != runningProcesses.end();
+        writeSummaryJson(out, summarizeLocked(process), running ? "running" : "waiting");
+        return true;
+    }
+    if (const ProcessSummary* finished = finishedArchive.findByPid(pid)) {
+        writeSummaryJson(out, *finished, "finished");
+        return true;
+    }
+    return false;
 }
 
+void CPUScheduler::writeProcessListJson(std::ostream& out, const std::string& sortKey, size_t topN) const {
+    SchedulerSnapshot snap = takeSnapshot(true, 0);
+    std::vector<std::pair<ProcessSummary, const char*>> live;
+    live.reserve(snap.running.size() + snap.waiting.size());
+    for (auto& process : snap.running) live.emplace_back(std::move(process), "running");
+    for (auto& process : snap.waiting) live.emplace_back(std::move(process), "waiting");
+
+    SummaryLess less = processSortOrder(sortKey);
+    if (!less) less = processSortOrder("cpu");
+    size_t shown = (topN == 0 || topN > live.size()) ? live.size() : topN;
+    std::partial_sort(live.begin(), live.begin() + shown, live.end(),
+        [less](const auto& a, const auto& b) { return less(a.first, b.first); });
+
+    out << "{\"live\":" << live.size() << ",\"finished\":" << snap.finishedTotal << ",\"processes\":[";
+    for (size_t i = 0; i < shown; ++i) {
+        if (i > 0) out << ",";
+        writeSummaryJson(out, live[i].first, live[i].second);
+    }
+    out << "]}";
+}
 
 
-bool CPUScheduler::addProcessWithInstructions(const std::string& name, int memSize, const std::string& instructions) {
+
+bool CPUScheduler::addProcessWithInstructions(const std::string& name, int memSize, const std::string& instructions,
+                                              ProgramPtr program) {
     if (!initialized) {
         std::cout << "Please initialize the scheduler first." << std::endl;
         return false;
@@ -604,33 +1710,84 @@ bool CPUScheduler::addProcessWithInstructions(const std::string& name, int memSi
         return false;
     }
 
-    // Create new process with specified memory size
-    auto process = std::make_shared<Process>(name, processCounter++, memSize);
-
-    // Parse and set custom instructions
-    if (!process->parseUserInstructions(instructions)) {
-        std::cout << "Error parsing instructions for process " << name << std::endl;
+    // Compiled once per distinct source; repeats share the cached image
+    std::string error;
+    if (!program) program = programCache.compile(instructions, error);
+    if (!program) {
+        std::cout << "Error parsing instructions for process " << name << ": " << error << std::endl;
         return false;
     }
 
-    // Add to ready queue
-    {
-        std::lock_guard<std::mutex> lock(schedulerMutex);
-        readyQueue.push(process);
+    // Create new process with specified memory size
+    auto process = ProcessPool::make(name, processCounter++, memSize);
+    process->setProgram(std::move(program));
+    if (!claimName(process)) {
+        std::cout << "Process " << name << " already exists." << std::endl;
+        return false;
     }
-    cv.notify_one();
+
+    // Add to ready queue (no memory allocation for custom processes)
+    Admission admission;
+    admission.process = process;
+    admission.source = instructions;
+    admission.allocate = false;
+    submit(std::move(admission));
 
     return true;
 }
 
-double CPUScheduler::getCpuUtilization() const {
-    return static_cast<double>(runningProcesses.size()) / config.getNumCpu() * 100.0;
-}
+bool CPUScheduler::loadWorkload(const std::string& filename) {
+    if (!initialized) {
+        std::cout << "Please initialize the scheduler first." << std::endl;
+        return false;
+    }
 
-int CPUScheduler::getCoresUsed() const {
-    return static_cast<int>(runningProcesses.size());
-}
+    auto loadStart = std::chrono::steady_clock::now();
+    workloadfile::File file;
+    std::string error;
+    if (!file.open(filename, error)) {
+        std::cout << "Error: " << error << std::endl;
+        return false;
+    }
+
+    uint32_t loaded = 0;
+    uint32_t skipped = 0;
+    uint64_t instructions = 0;
+    for (uint32_t i = 0; i < file.getCount(); ++i) {
+        workloadfile::ProgramHeader program;
+        if (!file.next(program)) {
+            std::cout << "Error: " << filename << " is truncated after " << i << " programs." << std::endl;
+            break;
+        }
 
-int CPUScheduler::getCoresAvailable() const {
-    return config.getNumCpu() - static_cast<int>(runningProcesses.size());
-}
\ No newline at end of file
+        std::string name(program.name);
+        bool usable = workloadfile::validMemorySize(program.memSize) && checkExistingProcess(name);
+        auto process = ProcessPool::make(name, usable ? static_cast<int>(processCounter++) : 0,
+                                         usable ? program.memSize : 0);
+        Program code(&process->arena);
+        if (!decodeProgram(file.reader(), code)) {
+            std::cout << "Error: " << filename << " has a corrupt program " << name << "." << std::endl;
+            break;
+        }
+        if (!usable || !claimName(process)) {
+            skipped++;
+            continue;
+        }
+
+        instructions += code.size();
+        process->setProgram(process->adoptProgram(std::move(code)));
+        Admission admission;
+        admission.process = std::move(process);
+        admission.source = std::string(program.source);
+        admission.allocate = false; // same as screen -c
+        admission.quiet = true;
+        submit(std::move(admission));
+        loaded++;
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - loadStart);
+    std::cout << "Loaded " << loaded << " programs (" << instructions << " instructions) from " << filename;
+    if (skipped) std::cout << ", skipped " << skipped << " with duplicate names or bad memory sizes";
+    std::cout << " in " << elapsed.count() / 1000.0 << " ms." << std::endl;
+    return true;
+}
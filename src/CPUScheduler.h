@@ -2,13 +2,46 @@
 #include "MemoryManager.h" // new addition
 #include "Process.h"
 #include "Config.h"
+#include "FinishedArchive.h"
+#include "Workload.h"
+#include "LoadGenerator.h"
+#include "SimClock.h"
+#include "Pacer.h"
+#include "RunTrace.h"
+#include "Tracer.h"
+#include "Histogram.h"
+#include "MetricsSampler.h"
+#include "ProgramCache.h"
+#include <deque>
 #include <queue>
+#include <unordered_map>
 #include <vector>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
 #include <atomic>
 #include <memory>
+#include <chrono>
+
+// Everything the report commands print, captured in one short critical section
+struct SchedulerSnapshot {
+    std::vector<ProcessSummary> running;
+    std::vector<ProcessSummary> waiting;
+    std::vector<ProcessSummary> finished; // most recent last; may be truncated
+    size_t finishedTotal = 0;
+    size_t finishedDropped = 0;           // aged out of the archive
+    int numCpu = 0;
+    int totalMemory = 0;
+    int usedMemory = 0;
+    int memPerFrame = 1;
+    int pageIns = 0;
+    int pageOuts = 0;
+};
+
+namespace checkpoint {
+class Writer;
+class File;
+}
 
 class CPUScheduler {
 public:
@@ -20,64 +53,195 @@ public:
     void shutdown();
     
     // Process management
-    void addProcess(const std::string& name, int memSize = -1);
+    bool addProcess(const std::string& name, int memSize = -1); // false if the name is taken
     ProcessPtr getProcess(const std::string& name);
-    ProcessPtr getAllProcess(const std::string& name);
+    bool getFinishedSummary(const std::string& name, ProcessSummary& out) const;
     bool checkExistingProcess(const std::string& name);
     ProcessPtr getProcessByPID(int pid);
 
     // new
-    bool addProcessWithInstructions(const std::string& name, int memSize, const std::string& instructions);
+    // program, if given, is the image compileProgram returned for instructions
+    bool addProcessWithInstructions(const std::string& name, int memSize, const std::string& instructions,
+                                    ProgramPtr program = nullptr);
+    // screen -c source to a shared image through the program cache; null with error set
+    ProgramPtr compileProgram(const std::string& source, std::string& error) { return programCache.compile(source, error); }
+
+    // Quiet submission for programmatic clients. Empty instructions generate a
+    // random program (memSize 0 draws the size). Returns the pid, or -1 with error set.
+    int submitProcess(const std::string& name, int memSize, const std::string& instructions, std::string& error);
+
+    // Admits every program in a compiled workload file (see WorkloadFile.h)
+    bool loadWorkload(const std::string& filename);
 
     // Batch processing
     void startBatchGeneration();
     void stopBatchGeneration();
+
+    // Record / replay (deterministic mode only)
+    bool startRecording(const std::string& filename); // arms the next initialize
+    bool stopRecording();                             // false if nothing was recording
+    bool replay(const std::string& filename);         // runs a recorded trace to completion
+
+    // Full simulator state; restore replaces initialize
+    bool checkpoint(const std::string& filename);
+    bool restore(const std::string& filename);
+
+    // Timeline tracing (Chrome trace JSON)
+    void startTracing();
+    void stopTracing(const std::string& filename);
+
+    // Time-series metrics, one row every interval CPU ticks
+    bool startMetrics(const std::string& filename, uint64_t interval);
+    void stopMetrics();
     
     // Reporting
     void listProcesses();
     void generateReport();
     void printVmstat() const; // vmstat command
-    void printProcessSMI();
+    void printProcessSMI(const std::string& sortKey = "cpu", size_t topN = 20);
+    static bool isProcessSortKey(const std::string& key);
+    void printStats() const; // stats command
+    void writeResultsJson(std::ostream& out) const; // headless summary, vmstat as JSON
+    bool writeProcessJson(std::ostream& out, int pid) const;
+    void writeProcessListJson(std::ostream& out, const std::string& sortKey, size_t topN) const;
     
     std::vector<ProcessPtr> listAllProcesses();
 
     // Getters
     bool isInitialized() const { return initialized; }
     bool isBatchRunning() const { return batchGenerationRunning; }
+    bool isDeterministic() const { return deterministic; }
+    uint64_t getCpuTicks() const { return clock.now(); }
+    uint64_t getActiveTicks() const { return activeCpuTicks; }
+
+    // Blocks until the simulated clock reaches tick; false if shut down first
+    bool waitForTick(uint64_t tick);
     
 private:
     Config config;
     std::queue<ProcessPtr> readyQueue;
     std::vector<ProcessPtr> runningProcesses;
-    std::vector<ProcessPtr> finishedProcesses;
-    std::vector<std::thread> coreThreads;
+    std::unordered_map<std::string, ProcessPtr> liveByName; // submitted, not yet finished
+    std::unordered_map<int, ProcessPtr> liveByPid;
+    FinishedArchive finishedArchive;
     std::thread batchGeneratorThread;
-    int currentQuantumCycle = 0;
-    int quantumCycleCount = 0;
+    std::atomic<uint64_t> currentQuantumCycle{0};
+    std::atomic<int> quantumCycleCount{0};
+
+    // Simulated cores are plain state; a pool of host workers sized to the
+    // hardware multiplexes them (core i runs on worker i % workerCount).
+    struct SimCore {
+        int id;
+        ProcessPtr process;
+        CorePacer pacer;
+        unsigned long stall = 0; // deterministic mode: cycles left before the next instruction
+
+        explicit SimCore(int coreId) : id(coreId) {}
+    };
+    std::vector<SimCore> cores;
+    std::vector<std::thread> workerThreads;
 
     mutable std::mutex schedulerMutex;
     
     std::condition_variable cv;
     std::atomic<bool> schedulerRunning{false};
     std::atomic<bool> batchGenerationRunning{false};
-    std::atomic<uint64_t> cpuTicks{0};
+    std::atomic<size_t> readyCount{0};
+    SimClock clock;
     std::atomic<uint64_t> processCounter{1};
     std::atomic<uint64_t> idleCpuTicks{0};
     std::atomic<uint64_t> activeCpuTicks{0};
+    std::chrono::steady_clock::time_point startTime;
 
     
     bool initialized = false;
     
     FirstFitMemoryAllocator memoryManager; // new addition
+    WorkloadGenerator workload;
+    LoadGenerator loadGenerator;
+    ProgramCache programCache; // screen -c sources -> shared compiled images
+
+    // A process on its way into the ready queue
+    struct Admission {
+        ProcessPtr process;
+        std::string source;   // screen -c instructions; empty if generated
+        int insOverride = -1; // instruction count pinned by an arrival trace
+        bool allocate = true;
+        bool quiet = false;   // don't report allocation failures
+    };
+
+    // Deterministic mode: one worker steps every core in order and the clock
+    // is virtual, so a run depends only on the seed and the submitted work.
+    // Submissions wait in pendingAdmissions until the next pass boundary.
+    bool deterministic = false;
+    std::deque<Admission> pendingAdmissions;
+    Arrival nextBatchArrival;
+    bool batchArrivalPending = false;
+    uint64_t idleWakeTick = UINT64_MAX; // earliest waitForTick target, so idle time can jump there
+
+    RunRecorder recorder;
+    std::string recordFile;
+    RunReplayer replayer;
+    std::atomic<bool> replaying{false};
+    bool replayDone = false;
+    std::atomic<bool> tracing{false};
+
+    Tracer tracer;
+
+    // Checkpoints park every worker at the top of its loop
+    std::atomic<bool> pauseRequested{false};
+    size_t pausedWorkers = 0; // schedulerMutex
+    std::condition_variable pauseCv;
+
+    // Per-process scheduling latencies in CPU ticks, updated as they happen
+    struct LatencyStats {
+        LatencyHistogram response;   // arrival -> first dispatch
+        LatencyHistogram waiting;    // total ready-queue time, per finished process
+        LatencyHistogram turnaround; // arrival -> finish
+        LatencyHistogram readyQueue; // each stay in the ready queue
+    };
+    LatencyStats latency;
+
+    MetricsSampler metrics;
+    int lastPageIns = 0; // page counters at the previous sample; schedulerMutex
+    int lastPageOuts = 0;
 
     // Private methods
     bool loadConfig();
-    void coreWorker(int coreId);
+    bool start(uint64_t seed, bool deterministicMode, const checkpoint::File* from = nullptr);
+    void discardRunState();
+    RunHeader configHeader(uint64_t seed) const;
+    bool matchesConfig(const RunHeader& header, const char* what) const;
+    void pauseWorkers();
+    void resumeWorkers();
+    void parkWorker();
+    size_t saveStateLocked(checkpoint::Writer& writer) const;
+    bool loadState(const checkpoint::File& file, std::string& error);
+    void coreWorker(int workerId, int workerCount);
+    void deterministicWorker();
+    bool submit(Admission admission);
+    bool admit(Admission& admission);
+    void admitDue();
+    uint64_t nextArrivalTickLocked();
+    Admission fromRecorded(const RunEvent& event);
+    void emitRunEvent(RunEventType type, int core, int pid, int64_t a = 0, int64_t b = 0,
+                      const std::string& name = {}, const std::string& source = {});
+    void finishReplay();
+    void onPageEvent(bool pageIn, int pid, int page, int frame); // not under schedulerMutex
+    void sampleMetrics(uint64_t tick);
+    bool stepCore(SimCore& core, CorePacer::Clock::time_point now);
+    void releaseCore(SimCore& core);
+    void checkMemoryDump();
+    void enqueueReady(const ProcessPtr& process);
+    bool claimName(const ProcessPtr& process);
+    void registerLocked(const ProcessPtr& process);
+    void unregisterLocked(const ProcessPtr& process);
     void batchGenerator();
-    void tickCounter();
     
-    // Statistics helpers
-    double getCpuUtilization() const;
-    int getCoresUsed() const;
-    int getCoresAvailable() const;
+    // Reporting helpers
+    SchedulerSnapshot takeSnapshot(bool includeWaiting, size_t maxFinished) const;
+    ProcessSummary summarizeLocked(const ProcessPtr& process) const;
+    static void writeUtilization(std::ostream& out, const SchedulerSnapshot& snap, bool showPid);
+    void writeLatency(std::ostream& out) const;
+    static void writeSummaryJson(std::ostream& out, const ProcessSummary& process, const char* status);
 };
\ No newline at end of file
@@ -0,0 +1,290 @@
+#include "Checkpoint.h"
+#include "ProgramCodec.h"
+#include "ProcessPool.h"
+#include <fstream>
+
+namespace checkpoint {
+
+namespace {
+
+constexpr size_t headerSize = 16;
+constexpr size_t entrySize = 24;
+
+size_t align8(size_t offset) {
+    return (offset + 7) & ~static_cast<size_t>(7);
+}
+
+uint64_t timeToBits(std::chrono::system_clock::time_point time) {
+    return static_cast<uint64_t>(time.time_since_epoch().count());
+}
+
+std::chrono::system_clock::time_point timeFromBits(uint64_t bits) {
+    return std::chrono::system_clock::time_point(
+        std::chrono::system_clock::duration(static_cast<std::chrono::system_clock::rep>(bits)));
+}
+
+void writeInts(BinaryWriter& out, const std::pmr::vector<int>& values) {
+    out.varint(values.size());
+    for (int value : values) out.svarint(value);
+}
+
+void readInts(BinaryReader& in, std::pmr::vector<int>& values) {
+    uint64_t count = in.varint();
+    values.clear();
+    for (uint64_t i = 0; i < count && !in.failed(); ++i) {
+        values.push_back(static_cast<int>(in.svarint()));
+    }
+}
+
+} // namespace
+
+bool Writer::save(const std::string& filename) const {
+    BinaryWriter header;
+    header.u32(magic);
+    header.u32(version);
+    header.u32(static_cast<uint32_t>(sections.size()));
+    header.u32(0);
+
+    size_t offset = align8(headerSize + entrySize * sections.size());
+    for (const auto& [id, body] : sections) {
+        header.u32(static_cast<uint32_t>(id));
+        header.u32(0);
+        header.u64(offset);
+        header.u64(body.size());
+        offset = align8(offset + body.size());
+    }
+
+    std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) return false;
+
+    static const char padding[8] = {};
+    size_t written = header.size();
+    header.appendTo(out);
+    for (const auto& [id, body] : sections) {
+        out.write(padding, static_cast<std::streamsize>(align8(written) - written));
+        body.appendTo(out);
+        written = align8(written) + body.size();
+    }
+    return static_cast<bool>(out);
+}
+
+bool File::open(const std::string& filename, std::string& error) {
+    index.clear();
+    if (!file.open(filename)) {
+        error = "could not open " + filename;
+        return false;
+    }
+
+    BinaryReader header(file.data(), file.size());
+    if (header.u32() != magic) {
+        error = filename + " is not a checkpoint";
+        return false;
+    }
+    uint32_t fileVersion = header.u32();
+    if (fileVersion != version) {
+        error = "unsupported checkpoint version " + std::to_string(fileVersion);
+        return false;
+    }
+    uint32_t count = header.u32();
+    header.u32();
+    for (uint32_t i = 0; i < count; ++i) {
+        Section id = static_cast<Section>(header.u32());
+        header.u32();
+        uint64_t offset = header.u64();
+        uint64_t size = header.u64();
+        if (header.failed() || offset > file.size() || size > file.size() - offset) {
+            error = filename + " is truncated";
+            return false;
+        }
+        index[id] = {offset, size};
+    }
+    return true;
+}
+
+BinaryReader File::section(Section id) const {
+    auto it = index.find(id);
+    if (it == index.end()) return BinaryReader(file.data(), 0);
+    return BinaryReader(file.data() + it->second.first, static_cast<size_t>(it->second.second));
+}
+
+void writeProcess(BinaryWriter& out, const Process& process) {
+    out.str(process.name);
+    out.svarint(process.pid);
+    out.svarint(process.memorySize);
+    out.svarint(process.totalInstructions);
+    out.svarint(process.currentInstruction);
+    out.u64(timeToBits(process.creationTime));
+    out.u64(timeToBits(process.finishTime));
+    out.svarint(process.assignedCore);
+    out.u8(static_cast<uint8_t>(process.isFinished | process.accessViolation << 1 | process.isSleeping << 2));
+    out.str(process.invalidAccess);
+    out.str(process.faultMessage);
+
+    out.varint(process.memory.size());
+    for (size_t page = 0; page < process.memory.pageCount(); ++page) {
+        out.bytes(process.memory.page(page), process.memory.pageLength(page));
+    }
+
+    std::vector<LogRecord> logs = process.printLogs.snapshot();
+    out.varint(process.printLogs.size());
+    out.varint(logs.size());
+    for (const LogRecord& record : logs) {
+        out.u64(timeToBits(record.time));
+        out.u32(record.arg);
+        out.u16(record.value);
+        out.u16(static_cast<uint16_t>(record.coreId));
+        out.u8(static_cast<uint8_t>(record.kind));
+    }
+
+    encodeProgram(out, *process.program);
+
+    out.varint(process.variableCount);
+    for (size_t slot = 0; slot < process.variables.size(); ++slot) {
+        if (process.variables[slot] < 0) continue;
+        out.varint(slot);
+        out.u16(static_cast<uint16_t>(process.variables[slot]));
+    }
+
+    out.svarint(process.remainingQuantum);
+    out.svarint(process.sleepCounter);
+    writeInts(out, process.forLoopStack);
+    writeInts(out, process.forLoopCounters);
+
+    out.u64(process.arrivalTick);
+    out.u64(process.firstDispatchTick);
+    out.u64(process.readySinceTick);
+    out.u64(process.finishTick);
+    out.varint(process.readyWaitTicks);
+    out.varint(process.preemptTicks.size());
+    for (uint64_t tick : process.preemptTicks) out.varint(tick);
+    out.varint(process.cpuTicks);
+    out.varint(process.sleepTicks);
+    out.varint(process.contextSwitches);
+}
+
+ProcessPtr readProcess(BinaryReader& in) {
+    std::string name(in.str());
+    int pid = static_cast<int>(in.svarint());
+    int memorySize = static_cast<int>(in.svarint());
+    if (in.failed() || memorySize < 0 || memorySize > 65536) return nullptr;
+
+    auto process = ProcessPool::make(name, pid, memorySize);
+    int totalInstructions = static_cast<int>(in.svarint());
+    process->currentInstruction = static_cast<int>(in.svarint());
+    process->creationTime = timeFromBits(in.u64());
+    process->finishTime = timeFromBits(in.u64());
+    process->assignedCore = static_cast<int>(in.svarint());
+    uint8_t flags = in.u8();
+    process->isFinished = flags & 1;
+    process->accessViolation = flags & 2;
+    process->isSleeping = flags & 4;
+    process->invalidAccess = std::string(in.str());
+    process->faultMessage = std::string(in.str());
+
+    uint64_t memoryBytes = in.varint();
+    if (memoryBytes != static_cast<uint64_t>(memorySize)) return nullptr;
+    const uint8_t* bytes = in.take(memoryBytes);
+    if (!bytes) return nullptr;
+    process->memory.assign(bytes, memoryBytes);
+
+    uint64_t pushed = in.varint();
+    uint64_t kept = in.varint();
+    if (kept > LogRing::capacity || kept > pushed) return nullptr;
+    std::vector<LogRecord> logs(kept);
+    for (LogRecord& record : logs) {
+        record.time = timeFromBits(in.u64());
+        record.arg = in.u32();
+        record.value = in.u16();
+        record.coreId = static_cast<int16_t>(in.u16());
+        record.kind = static_cast<LogKind>(in.u8());
+    }
+    process->printLogs.restore(logs, pushed);
+
+    Program program(&process->arena);
+    if (!decodeProgram(in, program)) return nullptr;
+    process->setProgram(process->adoptProgram(std::move(program)));
+
+    uint64_t variableCount = in.varint();
+    for (uint64_t i = 0; i < variableCount && !in.failed(); ++i) {
+        uint64_t slot = in.varint();
+        uint16_t value = in.u16();
+        if (slot >= process->variables.size() || process->variables[slot] >= 0) return nullptr;
+        process->variables[slot] = value;
+        process->variableCount++;
+    }
+
+    process->remainingQuantum = static_cast<int>(in.svarint());
+    process->sleepCounter = static_cast<int>(in.svarint());
+    readInts(in, process->forLoopStack);
+    readInts(in, process->forLoopCounters);
+
+    process->arrivalTick = in.u64();
+    process->firstDispatchTick = in.u64();
+    process->readySinceTick = in.u64();
+    process->finishTick = in.u64();
+    process->readyWaitTicks = in.varint();
+    uint64_t preemptions = in.varint();
+    for (uint64_t i = 0; i < preemptions && !in.failed(); ++i) {
+        process->preemptTicks.push_back(in.varint());
+    }
+    process->cpuTicks = in.varint();
+    process->sleepTicks = in.varint();
+    process->contextSwitches = in.varint();
+
+    bool consistent = process->totalInstructions == totalInstructions &&
+                      process->currentInstruction <= process->totalInstructions &&
+                      process->forLoopStack.size() == process->forLoopCounters.size();
+    // FOR_END jumps back through these, so each must be a FOR_START in this program
+    const Program& code = *process->program;
+    for (int start : process->forLoopStack) {
+        if (start < 0 || static_cast<size_t>(start) >= code.size() || code.ops[start].code != OpCode::FOR_START) {
+            consistent = false;
+        }
+    }
+    return in.failed() || !consistent ? nullptr : process;
+}
+
+void writeSummary(BinaryWriter& out, const ProcessSummary& summary) {
+    out.str(summary.name);
+    out.svarint(summary.pid);
+    out.svarint(summary.memorySize);
+    out.u64(timeToBits(summary.creationTime));
+    out.u64(timeToBits(summary.finishTime));
+    out.svarint(summary.assignedCore);
+    out.svarint(summary.currentInstruction);
+    out.svarint(summary.totalInstructions);
+    out.u8(summary.memoryAllocated);
+    out.u8(static_cast<uint8_t>(summary.exitReason));
+    out.str(summary.invalidAccess);
+    out.varint(summary.cpuTicks);
+    out.varint(summary.sleepTicks);
+    out.varint(summary.contextSwitches);
+    out.varint(summary.preemptions);
+    out.svarint(summary.pageFaults);
+    out.svarint(summary.evictions);
+    out.svarint(summary.residentBytes);
+}
+
+bool readSummary(BinaryReader& in, ProcessSummary& summary) {
+    summary.name = std::string(in.str());
+    summary.pid = static_cast<int>(in.svarint());
+    summary.memorySize = static_cast<int>(in.svarint());
+    summary.creationTime = timeFromBits(in.u64());
+    summary.finishTime = timeFromBits(in.u64());
+    summary.assignedCore = static_cast<int>(in.svarint());
+    summary.currentInstruction = static_cast<int>(in.svarint());
+    summary.totalInstructions = static_cast<int>(in.svarint());
+    summary.memoryAllocated = in.u8() != 0;
+    summary.exitReason = static_cast<ExitReason>(in.u8());
+    summary.invalidAccess = std::string(in.str());
+    summary.cpuTicks = in.varint();
+    summary.sleepTicks = in.varint();
+    summary.contextSwitches = in.varint();
+    summary.preemptions = in.varint();
+    summary.pageFaults = static_cast<int>(in.svarint());
+    summary.evictions = static_cast<int>(in.svarint());
+    summary.residentBytes = static_cast<int>(in.svarint());
+    return !in.failed();
+}
+
+} // namespace checkpoint
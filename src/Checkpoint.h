@@ -0,0 +1,61 @@
+#pragma once
+#include "BinaryIO.h"
+#include "MappedFile.h"
+#include "Process.h"
+#include <cstdint>
+#include <map>
+#include <string>
+
+// Container for `checkpoint` / `restore`. A fixed header and section table
+// are followed by 8-byte aligned sections, so the file is mapped read-only
+// and each section is decoded in place with a BinaryReader:
+//
+//   u32 magic "CSCP", u32 version, u32 sections, u32 reserved
+//   sections x {u32 id, u32 reserved, u64 offset, u64 size}
+//
+// Fixed-width tables (memory frames) and process memory are raw bytes that
+// restore copies wholesale; everything else is varint-encoded.
+namespace checkpoint {
+
+constexpr uint32_t magic = 0x50435343; // "CSCP"
+constexpr uint32_t version = 4;
+
+enum class Section : uint32_t {
+    Meta = 1,       // config fingerprint, seed, clock and counters
+    Memory = 2,     // FirstFitMemoryAllocator
+    Processes = 3,  // running, ready and pending processes in order
+    Archive = 4,    // finished-process summaries
+    Latency = 5,    // scheduling histograms
+    Arrivals = 6,   // batch arrival stream position
+};
+
+class Writer {
+public:
+    BinaryWriter& section(Section id) { return sections[id]; }
+    bool save(const std::string& filename) const;
+
+private:
+    std::map<Section, BinaryWriter> sections;
+};
+
+// Read-only view of a checkpoint file; mapped where the platform allows
+class File {
+public:
+    bool open(const std::string& filename, std::string& error);
+    // Empty reader (failed on first read) if the section is missing
+    BinaryReader section(Section id) const;
+    size_t size() const { return file.size(); }
+
+private:
+    MappedFile file;
+    std::map<Section, std::pair<uint64_t, uint64_t>> index; // id -> (offset, size)
+};
+
+// Full execution state of a live process
+void writeProcess(BinaryWriter& out, const Process& process);
+ProcessPtr readProcess(BinaryReader& in);
+
+void writeSummary(BinaryWriter& out, const ProcessSummary& summary);
+bool readSummary(BinaryReader& in, ProcessSummary& summary);
+
+} // namespace checkpoint
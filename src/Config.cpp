@@ -116,6 +116,74 @@ bool Config::loadFromFile(const std::string& filename) {
                 } else {
                     hasErrors = true;
                 }
+            } else if (key == "finished-archive-size") {
+                unsigned long val = std::stoul(value);
+                if (validateFinishedArchiveSize(val)) {
+                    finishedArchiveSize = val;
+                } else {
+                    hasErrors = true;
+                }
+            } else if (key == "generator-threads") {
+                int val = std::stoi(value);
+                if (validateGeneratorThreads(val)) {
+                    generatorThreads = val;
+                } else {
+                    hasErrors = true;
+                }
+            } else if (key == "program-cache-size") {
+                unsigned long val = std::stoul(value);
+                if (validateProgramCacheSize(val)) {
+                    programCacheSize = val;
+                } else {
+                    hasErrors = true;
+                }
+            } else if (key == "arrival-model") {
+                if (validateArrivalModel(value)) {
+                    arrivalModel = value;
+                } else {
+                    hasErrors = true;
+                }
+            } else if (key == "arrival-trace") {
+                arrivalTrace = value;
+            } else if (key == "burst-on-ticks" || key == "burst-off-ticks" || key == "diurnal-period") {
+                unsigned long val = std::stoul(value);
+                if (!validateTicks(key, val)) {
+                    hasErrors = true;
+                } else if (key == "burst-on-ticks") {
+                    burstOnTicks = val;
+                } else if (key == "burst-off-ticks") {
+                    burstOffTicks = val;
+                } else {
+                    diurnalPeriod = val;
+                }
+            } else if (key == "ins-dist") {
+                if (validateInsDist(value)) {
+                    insDist = value;
+                } else {
+                    hasErrors = true;
+                }
+            } else if (key == "mem-dist") {
+                if (validateMemDist(value)) {
+                    memDist = value;
+                } else {
+                    hasErrors = true;
+                }
+            } else if (key == "random-seed") {
+                randomSeed = std::stoull(value);
+            } else if (key == "deterministic") {
+                int val = std::stoi(value);
+                if (validateDeterministic(val)) {
+                    deterministic = val == 1;
+                } else {
+                    hasErrors = true;
+                }
+            } else if (key == "optimize") {
+                int val = std::stoi(value);
+                if (validateOptimize(val)) {
+                    optimize = val == 1;
+                } else {
+                    hasErrors = true;
+                }
             } else {
                 std::cerr << "Warning: Unknown parameter '" << key << "' in config file" << std::endl;
             }
@@ -250,6 +318,78 @@ bool Config::validateMaxMemPerProc(unsigned long value) const {
     return true;
 }
 
+bool Config::validateFinishedArchiveSize(unsigned long value) const {
+    if (value < 1 || value > 1000000) {
+        std::cerr << "Error: finished-archive-size must be in range [1, 1000000]. Got: " << value << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool Config::validateProgramCacheSize(unsigned long value) const {
+    if (value > 100000) {
+        std::cerr << "Error: program-cache-size must be in range [0, 100000]. Got: " << value << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool Config::validateGeneratorThreads(int value) const {
+    if (value < 1 || value > 64) {
+        std::cerr << "Error: generator-threads must be in range [1, 64]. Got: " << value << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool Config::validateArrivalModel(const std::string& value) const {
+    if (value != "fixed" && value != "poisson" && value != "bursty" && value != "diurnal" && value != "trace") {
+        std::cerr << "Error: arrival-model must be 'fixed', 'poisson', 'bursty', 'diurnal' or 'trace'. Got: " << value << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool Config::validateTicks(const std::string& key, unsigned long value) const {
+    if (value < 1 || value > UINT32_MAX) {
+        std::cerr << "Error: " << key << " must be in range [1, 2^32]. Got: " << value << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool Config::validateInsDist(const std::string& value) const {
+    if (value != "uniform" && value != "normal" && value != "exponential") {
+        std::cerr << "Error: ins-dist must be 'uniform', 'normal' or 'exponential'. Got: " << value << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool Config::validateMemDist(const std::string& value) const {
+    if (value != "uniform" && value != "geometric") {
+        std::cerr << "Error: mem-dist must be 'uniform' or 'geometric'. Got: " << value << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool Config::validateDeterministic(int value) const {
+    if (value != 0 && value != 1) {
+        std::cerr << "Error: deterministic must be 0 or 1. Got: " << value << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool Config::validateOptimize(int value) const {
+    if (value != 0 && value != 1) {
+        std::cerr << "Error: optimize must be 0 or 1. Got: " << value << std::endl;
+        return false;
+    }
+    return true;
+}
+
 void Config::createDefaultFile(const std::string& filename) const {
     std::ofstream defaultFile(filename);
     if (defaultFile.is_open()) {
@@ -264,6 +404,15 @@ void Config::createDefaultFile(const std::string& filename) const {
         defaultFile << "mem-per-frame 16\n";    // new addition
         defaultFile << "min-mem-per-proc 1024\n"; // new addition
         defaultFile << "max-mem-per-proc 4096\n"; // new addition
+        defaultFile << "finished-archive-size 1000\n";
+        defaultFile << "generator-threads 2\n";
+        defaultFile << "program-cache-size 256\n";
+        defaultFile << "arrival-model \"fixed\"\n";
+        defaultFile << "ins-dist \"uniform\"\n";
+        defaultFile << "mem-dist \"uniform\"\n";
+        defaultFile << "random-seed 0\n";
+        defaultFile << "deterministic 0\n";
+        defaultFile << "optimize 0\n";
 
         defaultFile.close();
         std::cout << "Created default " << filename << " file." << std::endl;
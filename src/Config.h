@@ -16,6 +16,22 @@ private:
     unsigned long memPerFrame = 16;     // new addition
     unsigned long minMemPerProc = 1024; // replaced memPerProc with minMemPerProc, must be power of 2 in [2^6, 2^16]
     unsigned long maxMemPerProc = 4096; // new addition for maxMemPerProc, must be power of 2 in [2^6, 2^16]
+    unsigned long finishedArchiveSize = 1000; // finished-process summaries kept for reporting
+    int generatorThreads = 2; // helper threads preparing batch processes
+    unsigned long programCacheSize = 256;     // compiled screen -c programs kept; 0 disables
+
+    // Load shape for batch generation (see LoadGenerator)
+    std::string arrivalModel = "fixed";     // fixed, poisson, bursty, diurnal, trace
+    std::string arrivalTrace = "arrivals.txt";
+    unsigned long burstOnTicks = 1000;
+    unsigned long burstOffTicks = 1000;
+    unsigned long diurnalPeriod = 100000;
+    std::string insDist = "uniform";        // uniform, normal, exponential
+    std::string memDist = "uniform";        // uniform, geometric
+
+    unsigned long long randomSeed = 0;      // 0 = pick a fresh seed each run
+    bool deterministic = false;             // single worker, virtual time (see CPUScheduler)
+    bool optimize = false;                  // run the static optimizer over programs (see Optimizer.h)
 
     // Validation methods
     bool validateNumCpu(int value) const;
@@ -30,6 +46,15 @@ private:
     // Must be power of 2 and in range [2^6, 2^16]
     bool validateMinMemPerProc(unsigned long value) const; // new addition
     bool validateMaxMemPerProc(unsigned long value) const; // new addition
+    bool validateFinishedArchiveSize(unsigned long value) const;
+    bool validateGeneratorThreads(int value) const;
+    bool validateProgramCacheSize(unsigned long value) const;
+    bool validateArrivalModel(const std::string& value) const;
+    bool validateTicks(const std::string& key, unsigned long value) const;
+    bool validateInsDist(const std::string& value) const;
+    bool validateMemDist(const std::string& value) const;
+    bool validateDeterministic(int value) const;
+    bool validateOptimize(int value) const;
 
     void createDefaultFile(const std::string& filename = "config.txt") const;
 
@@ -49,6 +74,19 @@ public:
     unsigned long getMemPerFrame() const { return memPerFrame; } // new addition
     unsigned long getMinMemPerProc() const { return minMemPerProc; } // new addition
     unsigned long getMaxMemPerProc() const { return maxMemPerProc; } // new addition
+    unsigned long getFinishedArchiveSize() const { return finishedArchiveSize; }
+    int getGeneratorThreads() const { return generatorThreads; }
+    unsigned long getProgramCacheSize() const { return programCacheSize; }
+    std::string getArrivalModel() const { return arrivalModel; }
+    std::string getArrivalTrace() const { return arrivalTrace; }
+    unsigned long getBurstOnTicks() const { return burstOnTicks; }
+    unsigned long getBurstOffTicks() const { return burstOffTicks; }
+    unsigned long getDiurnalPeriod() const { return diurnalPeriod; }
+    std::string getInsDist() const { return insDist; }
+    std::string getMemDist() const { return memDist; }
+    unsigned long long getRandomSeed() const { return randomSeed; }
+    bool isDeterministic() const { return deterministic; }
+    bool isOptimize() const { return optimize; }
 
     // Additional validation checks
     bool isRoundRobin() const { return scheduler == "rr"; }
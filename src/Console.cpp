@@ -1,9 +1,24 @@
 #include "Console.h"
+#include "ControlProtocol.h"
+#include "TimeFormat.h"
 #include <iostream>
 #include <sstream>
 #include <algorithm>
+#include <charconv>
 #include <cstdlib>
 
+namespace {
+
+// Whole-token unsigned parse; rejects signs, trailing junk and overflow
+template <typename T>
+bool parseCount(const std::string& token, T& out) {
+    const char* end = token.data() + token.size();
+    auto [ptr, ec] = std::from_chars(token.data(), end, out);
+    return ec == std::errc() && ptr == end;
+}
+
+} // namespace
+
 void Console::run() {
     displayHeader();
     mainLoop();
@@ -39,24 +54,93 @@ void Console::mainLoop() {
     }
 }
 
-void Console::handleMainCommand(const std::string& command) {
+int Console::runScript(std::istream& in) {
+    headless = true;
+    std::string line;
+    size_t executed = 0;
+    size_t failed = 0;
+
+    while (std::getline(in, line)) {
+        auto tokens = parseCommand(line);
+        if (tokens.empty() || tokens[0][0] == '#') continue;
+
+        std::cout << "> " << line << std::endl;
+        executed++;
+
+        if (currentScreen.isEmpty() && tokens[0] == "exit") break;
+
+        bool ok = true;
+        if (currentScreen.isEmpty() && tokens[0] == "wait") {
+            // wait <ticks>: block on the simulated clock, not the wall clock
+            uint64_t ticks = 0;
+            if (tokens.size() < 2 || !parseCount(tokens[1], ticks) || !scheduler.isInitialized()) {
+                std::cout << "Usage: wait <ticks> (after initialize)" << std::endl;
+                ok = false;
+            } else {
+                ok = scheduler.waitForTick(scheduler.getCpuTicks() + ticks);
+            }
+        } else if (currentScreen.isEmpty()) {
+            ok = handleMainCommand(line);
+        } else {
+            ok = handleScreenCommand(line);
+        }
+        if (!ok) failed++;
+    }
+
+    int status = failed == 0 ? 0 : 1;
+    std::cout << "{\"status\":\"" << (status == 0 ? "ok" : "failed") << "\",\"commands\":" << executed
+              << ",\"failed\":" << failed;
+    if (scheduler.isInitialized()) {
+        std::cout << ",\"scheduler\":";
+        scheduler.writeResultsJson(std::cout);
+    }
+    std::cout << "}" << std::endl;
+
+    control.stop();
+    scheduler.shutdown();
+    return status;
+}
+
+bool Console::handleMainCommand(const std::string& command) {
     auto tokens = parseCommand(command);
-    if (tokens.empty()) return;
+    if (tokens.empty()) return true;
     
     const std::string& cmd = tokens[0];
     
     if (cmd == "initialize") {
-        scheduler.initialize();
+        return scheduler.initialize();
     } else if (cmd == "exit") {
+        control.stop();
         scheduler.shutdown();
         std::exit(0);
     } else if (cmd == "clear") {
         clearScreen();
         displayHeader();
+    } else if (cmd == "record-start") {
+        if (tokens.size() < 2) {
+            std::cout << "Usage: record-start <file>" << std::endl;
+            return false;
+        }
+        return scheduler.startRecording(tokens[1]);
+    } else if (cmd == "record-stop") {
+        return scheduler.stopRecording();
+    } else if (cmd == "replay") {
+        if (tokens.size() < 2) {
+            std::cout << "Usage: replay <file>" << std::endl;
+            return false;
+        }
+        return scheduler.replay(tokens[1]);
+    } else if (cmd == "restore") {
+        if (tokens.size() < 2) {
+            std::cout << "Usage: restore <file>" << std::endl;
+            return false;
+        }
+        return scheduler.restore(tokens[1]);
     } else if (!scheduler.isInitialized() && cmd != "exit") {
         std::cout << "Please run 'initialize' first." << std::endl;
+        return false;
     } else if (cmd == "screen") {
-        handleScreenCommand(command);
+        return handleScreenCommand(command);
     } else if (cmd == "scheduler-start") {
         scheduler.startBatchGeneration();
     } else if (cmd == "scheduler-stop") {
@@ -66,42 +150,117 @@ void Console::handleMainCommand(const std::string& command) {
     } else if (cmd == "vmstat") {
         scheduler.printVmstat();
     } else if (cmd == "process-smi") {
-        scheduler.printProcessSMI();
+        // process-smi [-s <column>] [-n <count>]; -n 0 lists every live process
+        std::string sortKey = "cpu";
+        size_t topN = 20;
+        for (size_t i = 1; i < tokens.size(); i += 2) {
+            bool valid = i + 1 < tokens.size(); // every flag takes a value
+            if (valid && tokens[i] == "-s") {
+                sortKey = tokens[i + 1];
+            } else if (valid && tokens[i] == "-n") {
+                valid = parseCount(tokens[i + 1], topN);
+            } else {
+                valid = false;
+            }
+            if (!valid) {
+                std::cout << "Usage: process-smi [-s <column>] [-n <count>]" << std::endl;
+                return false;
+            }
+        }
+        if (!CPUScheduler::isProcessSortKey(sortKey)) {
+            std::cout << "Unknown sort column '" << sortKey << "'. Use pid, name, cpu, sleep, ctxsw, preempt, faults, evict or rss." << std::endl;
+            return false;
+        }
+        scheduler.printProcessSMI(sortKey, topN);
+    } else if (cmd == "stats") {
+        scheduler.printStats();
+    } else if (cmd == "trace-start") {
+        scheduler.startTracing();
+    } else if (cmd == "trace-stop") {
+        scheduler.stopTracing(tokens.size() >= 2 ? tokens[1] : "csopesy-trace.json");
+    } else if (cmd == "checkpoint") {
+        if (tokens.size() < 2) {
+            std::cout << "Usage: checkpoint <file>" << std::endl;
+            return false;
+        }
+        return scheduler.checkpoint(tokens[1]);
+    } else if (cmd == "load-workload") {
+        if (tokens.size() < 2) {
+            std::cout << "Usage: load-workload <file>" << std::endl;
+            return false;
+        }
+        return scheduler.loadWorkload(tokens[1]);
+    } else if (cmd == "metrics-start") {
+        // metrics-start [interval-ticks] [file]; a .bin file gets the columnar format
+        uint64_t interval = 100;
+        std::string file = tokens.size() >= 3 ? tokens[2] : "csopesy-metrics.csv";
+        if ((tokens.size() >= 2 && !parseCount(tokens[1], interval)) || interval == 0) {
+            std::cout << "Usage: metrics-start [interval-ticks > 0] [file]" << std::endl;
+            return false;
+        }
+        return scheduler.startMetrics(file, interval);
+    } else if (cmd == "metrics-stop") {
+        scheduler.stopMetrics();
+    } else if (cmd == "control-start") {
+        std::string path = tokens.size() >= 2 ? tokens[1] : control::defaultSocketPath;
+        if (control.isRunning()) {
+            std::cout << "Control socket already listening on " << control.getPath() << std::endl;
+        } else if (!control.start(path)) {
+            return false;
+        } else {
+            std::cout << "Control socket listening on " << path << std::endl;
+        }
+    } else if (cmd == "control-stop") {
+        if (!control.isRunning()) {
+            std::cout << "Control socket is not running." << std::endl;
+        } else {
+            uint64_t requests = control.getRequests();
+            uint64_t submitted = control.getSubmitted();
+            control.stop();
+            std::cout << "Control socket closed (" << requests << " requests, "
+                      << submitted << " processes submitted)." << std::endl;
+        }
     } else {
         std::cout << "Command not recognized." << std::endl;
+        return false;
     }
+    return true;
 }
 
-void Console::handleScreenCommand(const std::string& command) {
+bool Console::handleScreenCommand(const std::string& command) {
     if (currentScreen.isEmpty()) {
         auto tokens = parseCommand(command);
         if (tokens.size() < 2 || tokens[0] != "screen") {
             std::cout << "Invalid screen command format." << std::endl;
-            return;
+            return false;
         }
         
         const std::string& option = tokens[1];
         
         if (option == "-s" && tokens.size() >= 4) {
             const std::string& processName = tokens[2];
-            int memSize = std::stoi(tokens[3]);
+            int memSize = 0;
+            if (!parseCount(tokens[3], memSize)) {
+                std::cout << "invalid memory allocation" << std::endl;
+                return false;
+            }
 
             std::cout << "Adding process: " << processName << " with memory size: " << memSize << std::endl;
 
             // Validate memory size: power of 2 and in [64, 65536]
             if (memSize < 64 || memSize > 65536 || (memSize & (memSize - 1)) != 0) {
                 std::cout << "invalid memory allocation" << std::endl;
-                return;
+                return false;
             }
 
             if (!scheduler.checkExistingProcess(processName)) {
                 std::cout << "here if";
                 currentScreen.name = processName;
                 displayProcessScreen();
-                return;
+                return true;
             } else {
                 std::cout << "here else";
-                scheduler.addProcess(processName, memSize);
+                if (!scheduler.addProcess(processName, memSize)) return false;
                 std::cout << "Process " << processName << " added with memory size: " << memSize << " bytes." << std::endl;
                 currentScreen.name = processName;
 
@@ -111,22 +270,27 @@ void Console::handleScreenCommand(const std::string& command) {
         } else if (option == "-r" && tokens.size() >= 3) {
             const std::string& processName = tokens[2];
             auto process = scheduler.getProcess(processName);
+            ProcessSummary finished;
             if (process) {
                 currentScreen.name = processName;
                 displayProcessScreen();
+            } else if (scheduler.getFinishedSummary(processName, finished) &&
+                       finished.exitReason == ExitReason::AccessViolation) {
+                std::cout << "Process " << processName << " shut down due to memory access violation error that occurred at "
+                          << TimeFormat::format(finished.finishTime, TimeFormat::Style::Clock) << ". 0x" << finished.invalidAccess << " invalid." << std::endl;
             } else {
-                // if (auto process = scheduler.getAllProcess(processName)) {
-                //     std::string timestamp = getCurrentTimeString();
-                //     std::cout << "Process " << processName << " shut down due to memory access violation error that occurred at " << timestamp << ". 0x" << process->invalidAccess << " invalid." << std::endl;
-                // } else {
-                // }
                 std::cout << "Process " << processName << " not found." << std::endl;
+                return false;
             }
         } else if (option == "-ls") {
             scheduler.listProcesses();
         } else if (option == "-c" && tokens.size() >= 4) {
             const std::string& processName = tokens[2];
-            int memSize = std::stoi(tokens[3]);
+            int memSize = 0;
+            if (!parseCount(tokens[3], memSize)) {
+                std::cout << "invalid memory allocation" << std::endl;
+                return false;
+            }
             
             // Find the start and end of the instruction string (within quotes)
             size_t quoteStart = command.find("\"");
@@ -134,7 +298,7 @@ void Console::handleScreenCommand(const std::string& command) {
             
             if (quoteStart == std::string::npos || quoteEnd == std::string::npos || quoteStart == quoteEnd) {
                 std::cout << "invalid command: instructions must be enclosed in quotes" << std::endl;
-                return;
+                return false;
             }
             
             std::string instructions = command.substr(quoteStart + 1, quoteEnd - quoteStart - 1);
@@ -144,27 +308,18 @@ void Console::handleScreenCommand(const std::string& command) {
             //     return;
             // }
 
-            // Count number of valid (non-empty) instructions
-            std::stringstream ss(instructions);
-            std::string instr;
-            size_t count = 0;
-
-            while (std::getline(ss, instr, ';')) {
-                // Trim leading/trailing whitespace and ignore empty segments
-                if (!instr.empty() && instr.find_first_not_of(" \t\n\r") != std::string::npos) {
-                    count++;
-                }
-            }
-
-            if (count < 1 || count > 50) {
-                std::cout << "invalid command: must contain 1-50 instructions; current count: " << count << std::endl;
-                return;
+            // Syntax and the 1-50 statement limit; FOR bodies count statement by statement
+            std::string error;
+            ProgramPtr program = scheduler.compileProgram(instructions, error);
+            if (!program) {
+                std::cout << "invalid command: " << error << std::endl;
+                return false;
             }
 
             // Validate memory size: power of 2 and in [64, 65536]
             if (memSize < 64 || memSize > 65536 || (memSize & (memSize - 1)) != 0) {
                 std::cout << "invalid memory allocation" << std::endl;
-                return;
+                return false;
             }
 
             // Check if process already exists
@@ -172,19 +327,21 @@ void Console::handleScreenCommand(const std::string& command) {
                 std::cout << "Process " << processName << " already exists." << std::endl;
                 currentScreen.name = processName;
                 displayProcessScreen();
-                return;
+                return false;
             }
 
             // Add process with custom instructions
-            if (scheduler.addProcessWithInstructions(processName, memSize, instructions)) {
+            if (scheduler.addProcessWithInstructions(processName, memSize, instructions, program)) {
                 std::cout << "Process " << processName << " created with custom instructions." << std::endl;
                 currentScreen.name = processName;
                 displayProcessScreen();
             } else {
                 std::cout << "Failed to create process " << processName << " with custom instructions." << std::endl;
+                return false;
             }
         }   else {
             std::cout << "Invalid screen option. Use -s, -r, -c, or -ls." << std::endl;
+            return false;
         }
     } else {
         if (command == "exit") {
@@ -195,8 +352,10 @@ void Console::handleScreenCommand(const std::string& command) {
             displayProcessInfo();
         } else {
             std::cout << "Command '" << command << "' not recognized in screen mode." << std::endl;
+            return false;
         }
     }
+    return true;
 }
 
 void Console::displayProcessScreen() {
@@ -209,20 +368,29 @@ void Console::displayProcessScreen() {
 }
 
 std::string Console::getCurrentTimeString() {
-    std::time_t now = std::time(nullptr);
-    std::tm* local = std::localtime(&now);
-
-    char buffer[9];
-    std::strftime(buffer, sizeof(buffer), "%H:%M:%S", local);
-    return std::string(buffer);
+    return TimeFormat::now(TimeFormat::Style::Clock);
 }
 
 void Console::displayProcessInfo() {
 
-    auto process = scheduler.getAllProcess(currentScreen.name);
+    auto process = scheduler.getProcess(currentScreen.name);
     if (!process) {
-        std::cout << "Process " << currentScreen.name << " not found." << std::endl;
-        currentScreen.clear();
+        // Finished processes only keep a summary once they leave the scheduler
+        ProcessSummary finished;
+        if (!scheduler.getFinishedSummary(currentScreen.name, finished)) {
+            std::cout << "Process " << currentScreen.name << " not found." << std::endl;
+            currentScreen.clear();
+            return;
+        }
+
+        std::cout << "Process name: " << finished.name << std::endl;
+        std::cout << "ID: " << finished.pid << std::endl;
+        if (finished.exitReason == ExitReason::AccessViolation) {
+            std::cout << "\nShut down at " << TimeFormat::format(finished.finishTime) << ": memory access violation at 0x"
+                      << finished.invalidAccess << "\n" << std::endl;
+        } else {
+            std::cout << "\nFinished! (" << TimeFormat::format(finished.finishTime) << ")\n" << std::endl;
+        }
         return;
     }
     
@@ -230,7 +398,7 @@ void Console::displayProcessInfo() {
     std::cout << "ID: " << process->pid << std::endl;
     
     std::cout << "Logs:" << std::endl;
-    for (const auto& log : process->printLogs) {
+    for (const auto& log : process->formatLogs()) {
         std::cout << log << std::endl;
     }
 
@@ -245,6 +413,7 @@ void Console::displayProcessInfo() {
 }
 
 void Console::clearScreen() {
+    if (headless) return;
 #ifdef _WIN32
     system("cls");
 #else
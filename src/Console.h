@@ -1,14 +1,22 @@
 #pragma once
 #include "CPUScheduler.h"
+#include "ControlServer.h"
+#include <istream>
 #include <string>
 
 class Console {
 public:
     Console() = default;
     void run();
+
+    // Headless mode: runs one command per line from a script, never clears the
+    // screen, and ends with a JSON summary line. Returns the process exit code.
+    int runScript(std::istream& in);
     
 private:
     CPUScheduler scheduler;
+    ControlServer control{scheduler}; // declared after scheduler so it stops first
+    bool headless = false;
 
     struct ScreenContext {
     std::string name;
@@ -33,8 +41,8 @@ private:
     
     // Command handling
     void mainLoop();
-    void handleMainCommand(const std::string& command);
-    void handleScreenCommand(const std::string& command);
+    bool handleMainCommand(const std::string& command); // false if rejected
+    bool handleScreenCommand(const std::string& command); // false if rejected
     void handleVmstatCommand(); // new
     static std::string getCurrentTimeString();
     
@@ -0,0 +1,83 @@
+#pragma once
+#include "BinaryIO.h"
+#include <cstdint>
+#include <vector>
+
+// Wire format shared by the control server and csopesy-ctl. Every message is
+// a u32 little-endian length followed by that many bytes, encoded with
+// BinaryWriter. Requests start with an op byte, responses with a status byte:
+//
+//   Submit     varint n, n x {str name, varint mem, str instructions}
+//              -> n x {svarint pid, str error if pid < 0}
+//   QueryPid   svarint pid         -> str json
+//   Vmstat     (empty)             -> str json
+//   ProcessSmi str sortKey, varint topN -> str json
+//
+// An Error status is followed by a str message instead of the body. Many
+// programs go in one Submit frame, so bulk loads cost one round trip.
+namespace control {
+
+constexpr const char* defaultSocketPath = "csopesy.sock";
+constexpr uint32_t maxFrameSize = 16u << 20;
+
+enum class Op : uint8_t {
+    Submit = 1,
+    QueryPid = 2,
+    Vmstat = 3,
+    ProcessSmi = 4,
+};
+
+enum class Status : uint8_t {
+    Ok = 0,
+    Error = 1,
+};
+
+} // namespace control
+
+#ifndef _WIN32
+#include <cerrno>
+#include <unistd.h>
+
+namespace control {
+
+inline bool writeAll(int fd, const uint8_t* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = ::write(fd, data, size);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+inline bool readAll(int fd, uint8_t* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = ::read(fd, data, size);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+inline bool writeFrame(int fd, const BinaryWriter& body) {
+    BinaryWriter header;
+    header.u32(static_cast<uint32_t>(body.size()));
+    return writeAll(fd, header.data().data(), header.size())
+        && writeAll(fd, body.data().data(), body.size());
+}
+
+// False on EOF, I/O error or an oversized frame
+inline bool readFrame(int fd, std::vector<uint8_t>& body) {
+    uint8_t header[4];
+    if (!readAll(fd, header, sizeof(header))) return false;
+    uint32_t size = BinaryReader(header, sizeof(header)).u32();
+    if (size > maxFrameSize) return false;
+    body.resize(size);
+    return readAll(fd, body.data(), size);
+}
+
+} // namespace control
+#endif
@@ -0,0 +1,214 @@
+#include "ControlServer.h"
+#include "ControlProtocol.h"
+#include "CPUScheduler.h"
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif
+
+ControlServer::~ControlServer() {
+    stop();
+}
+
+void ControlServer::handle(BinaryReader& request, BinaryWriter& response) {
+    using control::Op;
+    using control::Status;
+
+    auto fail = [&response](const std::string& message) {
+        response.clear();
+        response.u8(static_cast<uint8_t>(Status::Error));
+        response.str(message);
+    };
+
+    if (!scheduler.isInitialized()) return fail("scheduler not initialized");
+
+    Op op = static_cast<Op>(request.u8());
+    std::ostringstream json;
+    switch (op) {
+        case Op::Submit: {
+            // Decode the whole batch first, so a truncated frame admits nothing
+            struct Entry {
+                std::string name;
+                int mem;
+                std::string instructions;
+            };
+            uint64_t count = request.varint();
+            std::vector<Entry> batch;
+            for (uint64_t i = 0; i < count && !request.failed(); ++i) {
+                Entry entry;
+                entry.name = std::string(request.str());
+                entry.mem = static_cast<int>(std::min<uint64_t>(request.varint(), INT32_MAX));
+                entry.instructions = std::string(request.str());
+                batch.push_back(std::move(entry));
+            }
+            if (request.failed()) return fail("truncated submit request");
+
+            response.u8(static_cast<uint8_t>(Status::Ok));
+            response.varint(count);
+            std::string error;
+            for (const Entry& entry : batch) {
+                error.clear();
+                int pid = scheduler.submitProcess(entry.name, entry.mem, entry.instructions, error);
+                response.svarint(pid);
+                if (pid < 0) {
+                    response.str(error);
+                } else {
+                    submitted++;
+                }
+            }
+            return;
+        }
+        case Op::QueryPid: {
+            int pid = static_cast<int>(request.svarint());
+            if (request.failed()) return fail("truncated pid request");
+            if (!scheduler.writeProcessJson(json, pid)) {
+                return fail("process " + std::to_string(pid) + " not found");
+            }
+            break;
+        }
+        case Op::Vmstat:
+            scheduler.writeResultsJson(json);
+            break;
+        case Op::ProcessSmi: {
+            std::string sortKey(request.str());
+            uint64_t topN = request.varint();
+            if (request.failed()) return fail("truncated process-smi request");
+            if (sortKey.empty()) sortKey = "cpu";
+            if (!CPUScheduler::isProcessSortKey(sortKey)) return fail("unknown sort key " + sortKey);
+            scheduler.writeProcessListJson(json, sortKey, static_cast<size_t>(topN));
+            break;
+        }
+        default:
+            return fail("unknown op " + std::to_string(static_cast<int>(op)));
+    }
+
+    response.u8(static_cast<uint8_t>(Status::Ok));
+    response.str(json.str());
+}
+
+#ifndef _WIN32
+
+bool ControlServer::start(const std::string& path) {
+    if (running) return false;
+    if (path.size() >= sizeof(sockaddr_un::sun_path)) {
+        std::cout << "Error: socket path too long: " << path << std::endl;
+        return false;
+    }
+
+    listenFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd < 0) {
+        std::cout << "Error: Could not create control socket" << std::endl;
+        return false;
+    }
+
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    path.copy(addr.sun_path, path.size());
+    ::unlink(path.c_str()); // stale socket from a previous run
+    if (::bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || ::listen(listenFd, 16) < 0) {
+        std::cout << "Error: Could not listen on " << path << std::endl;
+        ::close(listenFd);
+        listenFd = -1;
+        return false;
+    }
+
+    socketPath = path;
+    running = true;
+    acceptThread = std::thread(&ControlServer::acceptLoop, this);
+    return true;
+}
+
+void ControlServer::stop() {
+    if (!running.exchange(false)) return;
+
+    // shutdown() wakes threads blocked in accept() and read()
+    ::shutdown(listenFd, SHUT_RDWR);
+    if (acceptThread.joinable()) acceptThread.join();
+    ::close(listenFd);
+    listenFd = -1;
+
+    std::vector<std::thread> threads;
+    {
+        std::lock_guard<std::mutex> lock(clientsMutex);
+        for (int fd : clientFds) ::shutdown(fd, SHUT_RDWR);
+        threads.swap(clientThreads);
+        finishedClients.clear();
+    }
+    for (auto& thread : threads) thread.join();
+
+    ::unlink(socketPath.c_str());
+}
+
+// Joins client threads that have returned, so short-lived clients don't each
+// leave a thread stack mapped until stop()
+void ControlServer::reapClients() {
+    std::vector<std::thread> done;
+    {
+        std::lock_guard<std::mutex> lock(clientsMutex);
+        for (std::thread::id id : finishedClients) {
+            auto it = std::find_if(clientThreads.begin(), clientThreads.end(),
+                [id](const std::thread& thread) { return thread.get_id() == id; });
+            if (it == clientThreads.end()) continue;
+            done.push_back(std::move(*it));
+            clientThreads.erase(it);
+        }
+        finishedClients.clear();
+    }
+    for (auto& thread : done) thread.join();
+}
+
+void ControlServer::acceptLoop() {
+    while (running) {
+        int fd = ::accept(listenFd, nullptr, nullptr);
+        reapClients();
+        if (fd < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        std::lock_guard<std::mutex> lock(clientsMutex);
+        if (!running) {
+            ::close(fd);
+            break;
+        }
+        clientFds.push_back(fd);
+        clientThreads.emplace_back(&ControlServer::serveClient, this, fd);
+    }
+}
+
+void ControlServer::serveClient(int fd) {
+    std::vector<uint8_t> frame;
+    BinaryWriter response;
+    while (running && control::readFrame(fd, frame)) {
+        requests++;
+        BinaryReader request(frame.data(), frame.size());
+        response.clear();
+        handle(request, response);
+        if (!control::writeFrame(fd, response)) break;
+    }
+
+    std::lock_guard<std::mutex> lock(clientsMutex);
+    clientFds.erase(std::remove(clientFds.begin(), clientFds.end(), fd), clientFds.end());
+    finishedClients.push_back(std::this_thread::get_id());
+    ::close(fd);
+}
+
+#else
+
+bool ControlServer::start(const std::string&) {
+    std::cout << "Error: The control socket is not supported on Windows." << std::endl;
+    return false;
+}
+
+void ControlServer::stop() {}
+
+void ControlServer::acceptLoop() {}
+
+void ControlServer::reapClients() {}
+
+void ControlServer::serveClient(int) {}
+
+#endif
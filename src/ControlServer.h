@@ -0,0 +1,49 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class CPUScheduler;
+class BinaryReader;
+class BinaryWriter;
+
+// Local control API over a Unix domain socket (see ControlProtocol.h), so
+// scripts and load tools can submit programs and read stats without driving
+// the console. One thread accepts; each client gets its own thread, joined on
+// the next accept after it disconnects. Not available on Windows.
+class ControlServer {
+public:
+    explicit ControlServer(CPUScheduler& scheduler) : scheduler(scheduler) {}
+    ~ControlServer();
+
+    bool start(const std::string& path);
+    void stop();
+    bool isRunning() const { return running; }
+    const std::string& getPath() const { return socketPath; }
+
+    uint64_t getRequests() const { return requests; }
+    uint64_t getSubmitted() const { return submitted; }
+
+private:
+    void acceptLoop();
+    void reapClients();
+    void serveClient(int fd);
+    void handle(BinaryReader& request, BinaryWriter& response);
+
+    CPUScheduler& scheduler;
+    std::string socketPath;
+    std::atomic<bool> running{false};
+    int listenFd = -1;
+    std::thread acceptThread;
+
+    std::mutex clientsMutex;
+    std::vector<int> clientFds;
+    std::vector<std::thread> clientThreads;
+    std::vector<std::thread::id> finishedClients; // returned, not yet joined
+
+    std::atomic<uint64_t> requests{0};
+    std::atomic<uint64_t> submitted{0};
+};
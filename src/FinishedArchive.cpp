@@ -0,0 +1,46 @@
+#include "FinishedArchive.h"
+#include <algorithm>
+
+FinishedArchive::FinishedArchive(size_t capacity) : capacity(std::max<size_t>(capacity, 1)) {}
+
+void FinishedArchive::reset(size_t newCapacity) {
+    ring.clear();
+    ring.shrink_to_fit();
+    capacity = std::max<size_t>(newCapacity, 1);
+    head = 0;
+    count = 0;
+    total = 0;
+}
+
+void FinishedArchive::add(ProcessSummary summary) {
+    // Grow lazily so a large capacity costs nothing until it is used
+    if (ring.size() < capacity) {
+        ring.push_back(std::move(summary));
+    } else {
+        ring[head] = std::move(summary);
+    }
+    head = (head + 1) % capacity;
+    count = std::min(count + 1, capacity);
+    total++;
+}
+
+const ProcessSummary& FinishedArchive::at(size_t index) const {
+    size_t oldest = (count < capacity) ? 0 : head;
+    return ring[(oldest + index) % capacity];
+}
+
+const ProcessSummary* FinishedArchive::findByName(const std::string& name) const {
+    for (size_t i = count; i-- > 0;) {
+        const ProcessSummary& summary = at(i);
+        if (summary.name == name) return &summary;
+    }
+    return nullptr;
+}
+
+const ProcessSummary* FinishedArchive::findByPid(int pid) const {
+    for (size_t i = count; i-- > 0;) {
+        const ProcessSummary& summary = at(i);
+        if (summary.pid == pid) return &summary;
+    }
+    return nullptr;
+}
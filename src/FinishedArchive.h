@@ -0,0 +1,35 @@
+#pragma once
+#include "Process.h"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+// Fixed-capacity ring of finished-process summaries. Once full the oldest
+// entry is overwritten; the full Process (instructions, logs, memory) is
+// released by the scheduler as soon as its summary is archived.
+class FinishedArchive {
+public:
+    explicit FinishedArchive(size_t capacity = 1000);
+
+    void reset(size_t newCapacity);
+    void add(ProcessSummary summary);
+
+    size_t size() const { return count; }
+    size_t totalArchived() const { return total; }
+    size_t dropped() const { return total - count; }
+    void setTotalArchived(size_t archived) { total = std::max(archived, count); } // restore
+
+    // 0 is the oldest retained entry
+    const ProcessSummary& at(size_t index) const;
+
+    // Newest match wins, so a reused name resolves to its latest run
+    const ProcessSummary* findByName(const std::string& name) const;
+    const ProcessSummary* findByPid(int pid) const;
+
+private:
+    std::vector<ProcessSummary> ring;
+    size_t capacity;
+    size_t head = 0;  // next slot to write
+    size_t count = 0;
+    size_t total = 0;
+};
@@ -0,0 +1,111 @@
+#pragma once
+#include "BinaryIO.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// HDR-style log-linear histogram of tick counts. Values below 128 are exact;
+// above that every power-of-two range is split into 64 buckets, so any
+// reported percentile is within ~1.6% of the true value. Recording is a few
+// relaxed atomic adds, safe from any number of workers at once.
+class LatencyHistogram {
+public:
+    static constexpr int subBucketBits = 7;
+    static constexpr uint64_t subBucketCount = 1ull << subBucketBits;  // 128
+    static constexpr uint64_t subBucketHalf = subBucketCount / 2;      // 64
+    static constexpr size_t bucketCount = subBucketCount + (64 - subBucketBits) * subBucketHalf;
+
+    void record(uint64_t value) {
+        counts[indexOf(value)].fetch_add(1, std::memory_order_relaxed);
+        total.fetch_add(1, std::memory_order_relaxed);
+        uint64_t seen = maximum.load(std::memory_order_relaxed);
+        while (value > seen && !maximum.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {}
+    }
+
+    uint64_t count() const { return total.load(std::memory_order_relaxed); }
+    uint64_t max() const { return maximum.load(std::memory_order_relaxed); }
+
+    // Highest value equivalent to the bucket holding the p-quantile (0 < p <= 1)
+    uint64_t percentile(double p) const {
+        uint64_t n = count();
+        if (n == 0) return 0;
+        uint64_t rank = static_cast<uint64_t>(p * n + 0.5);
+        if (rank < 1) rank = 1;
+
+        uint64_t seen = 0;
+        for (size_t i = 0; i < bucketCount; ++i) {
+            seen += counts[i].load(std::memory_order_relaxed);
+            if (seen >= rank) {
+                uint64_t upper = highestEquivalent(i);
+                uint64_t highest = max();
+                return upper < highest ? upper : highest;
+            }
+        }
+        return max();
+    }
+
+    void reset() {
+        for (auto& c : counts) c.store(0, std::memory_order_relaxed);
+        total.store(0, std::memory_order_relaxed);
+        maximum.store(0, std::memory_order_relaxed);
+    }
+
+    // Sparse: only non-empty buckets are written
+    void save(BinaryWriter& out) const {
+        size_t used = 0;
+        for (const auto& c : counts) used += c.load(std::memory_order_relaxed) != 0;
+        out.varint(used);
+        size_t last = 0;
+        for (size_t i = 0; i < bucketCount; ++i) {
+            uint64_t n = counts[i].load(std::memory_order_relaxed);
+            if (n == 0) continue;
+            out.varint(i - last);
+            out.varint(n);
+            last = i;
+        }
+        out.varint(max());
+    }
+
+    bool load(BinaryReader& in) {
+        reset();
+        uint64_t used = in.varint();
+        size_t index = 0;
+        uint64_t sum = 0;
+        for (uint64_t k = 0; k < used && !in.failed(); ++k) {
+            index += in.varint();
+            uint64_t n = in.varint();
+            if (index >= bucketCount) return false;
+            counts[index].store(n, std::memory_order_relaxed);
+            sum += n;
+        }
+        total.store(sum, std::memory_order_relaxed);
+        maximum.store(in.varint(), std::memory_order_relaxed);
+        return !in.failed();
+    }
+
+private:
+    static int msb(uint64_t value) {
+        int bit = 0;
+        while (value >>= 1) bit++;
+        return bit;
+    }
+
+    static size_t indexOf(uint64_t value) {
+        if (value < subBucketCount) return static_cast<size_t>(value);
+        int shift = msb(value) - (subBucketBits - 1); // >= 1
+        uint64_t sub = value >> shift;                 // in [64, 128)
+        return static_cast<size_t>(subBucketCount + (shift - 1) * subBucketHalf + (sub - subBucketHalf));
+    }
+
+    static uint64_t highestEquivalent(size_t index) {
+        if (index < subBucketCount) return index;
+        size_t offset = index - subBucketCount;
+        int shift = static_cast<int>(offset / subBucketHalf) + 1;
+        uint64_t sub = subBucketHalf + offset % subBucketHalf;
+        return ((sub + 1) << shift) - 1;
+    }
+
+    std::array<std::atomic<uint64_t>, bucketCount> counts{};
+    std::atomic<uint64_t> total{0};
+    std::atomic<uint64_t> maximum{0};
+};
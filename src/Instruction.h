@@ -12,6 +12,7 @@ enum class InstructionType {
     SLEEP,
     FOR_START,
     FOR_END,
+    NOP, // retires a cycle and does nothing; left by the optimizer
 };
 
 struct Instruction {
@@ -20,7 +21,24 @@ struct Instruction {
     int sleepCycles = 0;
     int forRepeats = 0;
     int memoryAddress = -1; 
+    int jumpTarget = -1; // parsed FOR blocks: index of the matching FOR_START / FOR_END
+    int constant = -1;   // precomputed value or result, see Optimizer.h
+    bool firstPassOnly = false; // no effect after the first iteration of its FOR block
 
     Instruction() = default;
     Instruction(InstructionType t) : type(t) {}
-};
\ No newline at end of file
+
+    // Same as assigning Instruction(t) with `count` empty params, except the
+    // params keep whatever capacity they had
+    void reset(InstructionType t, size_t count = 0) {
+        type = t;
+        params.resize(count);
+        for (std::string& param : params) param.clear();
+        sleepCycles = 0;
+        forRepeats = 0;
+        memoryAddress = -1;
+        jumpTarget = -1;
+        constant = -1;
+        firstPassOnly = false;
+    }
+};
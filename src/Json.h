@@ -0,0 +1,25 @@
+#pragma once
+#include <ostream>
+#include <string_view>
+
+// Writes text as a JSON string literal. Names and instructions come from
+// users, so anything unusual is escaped rather than trusted.
+inline void writeJsonString(std::ostream& out, std::string_view text) {
+    static const char hex[] = "0123456789abcdef";
+    out << '"';
+    for (char c : text) {
+        switch (c) {
+            case '"':  out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\n': out << "\\n"; break;
+            case '\t': out << "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    out << "\\u00" << hex[(c >> 4) & 0xF] << hex[c & 0xF];
+                } else {
+                    out << c;
+                }
+        }
+    }
+    out << '"';
+}
@@ -0,0 +1,156 @@
+#include "LoadGenerator.h"
+#include "WorkloadFile.h"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+bool LoadGenerator::configure(const Config& config, uint64_t seed) {
+    const std::string& name = config.getArrivalModel();
+    if (name == "poisson") {
+        model = Model::Poisson;
+    } else if (name == "bursty") {
+        model = Model::Bursty;
+    } else if (name == "diurnal") {
+        model = Model::Diurnal;
+    } else if (name == "trace") {
+        model = Model::Trace;
+    } else {
+        model = Model::Fixed;
+    }
+
+    interval = static_cast<double>(config.getBatchProcessFreq());
+    burstOn = static_cast<double>(config.getBurstOnTicks());
+    burstOff = static_cast<double>(config.getBurstOffTicks());
+    diurnalPeriod = static_cast<double>(config.getDiurnalPeriod());
+    rng = Xoshiro256::forStream(seed, ~0ull); // independent of the per-process streams
+
+    trace.clear();
+    if (model == Model::Trace && !loadTrace(config.getArrivalTrace())) {
+        return false;
+    }
+    return true;
+}
+
+static bool parseInt(const std::string& field, int& out) {
+    const char* end = field.data() + field.size();
+    auto [ptr, ec] = std::from_chars(field.data(), end, out);
+    return ec == std::errc() && ptr == end;
+}
+
+bool LoadGenerator::loadTrace(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        std::cout << "Error: Could not open arrival trace " << filename << std::endl;
+        return false;
+    }
+
+    std::string line;
+    int lineNo = 0;
+    while (std::getline(file, line)) {
+        lineNo++;
+        if (line.empty() || line[0] == '#') continue;
+
+        std::istringstream iss(line);
+        Arrival arrival;
+        if (!(iss >> arrival.tick)) {
+            std::cout << "Error: " << filename << ":" << lineNo << ": expected an arrival tick" << std::endl;
+            return false;
+        }
+        // Optional columns keep -1 ("draw from config") when absent, but must
+        // be well-formed when given
+        std::string memField, insField;
+        if (iss >> memField) {
+            if (!parseInt(memField, arrival.memSize) || !workloadfile::validMemorySize(arrival.memSize)) {
+                std::cout << "Error: " << filename << ":" << lineNo << ": invalid memory size '" << memField << "'" << std::endl;
+                return false;
+            }
+        }
+        if (iss >> insField) {
+            if (!parseInt(insField, arrival.instructions) || arrival.instructions < 1) {
+                std::cout << "Error: " << filename << ":" << lineNo << ": invalid instruction count '" << insField << "'" << std::endl;
+                return false;
+            }
+        }
+        trace.push_back(arrival);
+    }
+
+    std::stable_sort(trace.begin(), trace.end(),
+        [](const Arrival& a, const Arrival& b) { return a.tick < b.tick; });
+    return true;
+}
+
+void LoadGenerator::begin(uint64_t tick) {
+    startTick = tick;
+    cursor = 0.0;
+    traceIndex = 0;
+}
+
+double LoadGenerator::exponential(double mean) {
+    // 1 - u keeps the argument of log() in (0, 1]
+    return -std::log(1.0 - rng.uniform01()) * mean;
+}
+
+bool LoadGenerator::next(Arrival& out) {
+    out = Arrival{};
+
+    switch (model) {
+        case Model::Fixed:
+            cursor += interval;
+            break;
+        case Model::Poisson:
+            cursor += exponential(interval);
+            break;
+        case Model::Bursty: {
+            cursor += interval;
+            double cycle = burstOn + burstOff;
+            double phase = std::fmod(cursor, cycle);
+            if (phase >= burstOn) {
+                cursor += cycle - phase; // skip the quiet part of the cycle
+            }
+            break;
+        }
+        case Model::Diurnal: {
+            // Thinning: candidates at the peak rate, kept in proportion to the
+            // current rate, which averages out to one per batch-process-freq
+            constexpr double twoPi = 6.283185307179586;
+            while (true) {
+                cursor += exponential(interval / 2.0);
+                double level = (1.0 - std::cos(twoPi * cursor / diurnalPeriod)) / 2.0;
+                if (rng.uniform01() < level) break;
+            }
+            break;
+        }
+        case Model::Trace:
+            if (traceIndex >= trace.size()) return false;
+            out = trace[traceIndex++];
+            out.tick += startTick;
+            return true;
+    }
+
+    out.tick = startTick + static_cast<uint64_t>(std::llround(cursor));
+    return true;
+}
+
+void LoadGenerator::saveState(BinaryWriter& out) const {
+    for (uint64_t word : rng.getState()) out.u64(word);
+    out.u64(startTick);
+    uint64_t bits;
+    std::memcpy(&bits, &cursor, sizeof(bits));
+    out.u64(bits);
+    out.varint(traceIndex);
+}
+
+bool LoadGenerator::loadState(BinaryReader& in) {
+    std::array<uint64_t, 4> words;
+    for (auto& word : words) word = in.u64();
+    rng.setState(words);
+    startTick = in.u64();
+    uint64_t bits = in.u64();
+    std::memcpy(&cursor, &bits, sizeof(cursor));
+    traceIndex = static_cast<size_t>(in.varint());
+    return !in.failed() && traceIndex <= trace.size();
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include "BinaryIO.h"
+#include "Config.h"
+#include "Random.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// One batch arrival. Trace entries may pin the memory size or instruction
+// count; -1 leaves the choice to the workload generator.
+struct Arrival {
+    uint64_t tick = 0;
+    int memSize = -1;
+    int instructions = -1;
+};
+
+// Decides when batch processes arrive, in simulated CPU ticks. What each
+// process contains is left to WorkloadGenerator.
+//
+//   fixed    one arrival every batch-process-freq ticks (the original behaviour)
+//   poisson  exponential inter-arrival times, mean batch-process-freq
+//   bursty   fixed-rate arrivals during burst-on-ticks, none for burst-off-ticks
+//   diurnal  Poisson with a rate that ramps 0 -> 2x -> 0 over diurnal-period
+//   trace    replays arrival-trace: "<tick> [mem-size] [instructions]" per line
+class LoadGenerator {
+public:
+    enum class Model { Fixed, Poisson, Bursty, Diurnal, Trace };
+
+    bool configure(const Config& config, uint64_t seed);
+    void begin(uint64_t startTick);
+
+    // Next arrival at or after the previous one; false once a trace runs out
+    bool next(Arrival& out);
+
+    Model getModel() const { return model; }
+
+    // Position in the arrival stream, for checkpoints; configure() first
+    void saveState(BinaryWriter& out) const;
+    bool loadState(BinaryReader& in);
+
+private:
+    bool loadTrace(const std::string& filename);
+    double exponential(double mean);
+
+    Model model = Model::Fixed;
+    double interval = 1.0;
+    double burstOn = 1.0;
+    double burstOff = 1.0;
+    double diurnalPeriod = 1.0;
+    Xoshiro256 rng;
+
+    uint64_t startTick = 0;
+    double cursor = 0.0; // ticks since begin() of the last arrival
+    std::vector<Arrival> trace;
+    size_t traceIndex = 0;
+};
@@ -0,0 +1,67 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+enum class LogKind : uint8_t {
+    Print,          // arg = instruction index, value = variable operand
+    PrintUnknown,   // PRINT of an unresolvable variable
+    Error,          // instruction threw; text kept on the process
+    AccessViolation // arg = faulting address
+};
+
+// Raw log entry. Nothing is formatted until someone displays it.
+struct LogRecord {
+    std::chrono::system_clock::time_point time;
+    uint32_t arg = 0;
+    uint16_t value = 0;
+    int16_t coreId = -1;
+    LogKind kind = LogKind::Print;
+};
+
+// Fixed-capacity ring of the most recent log records for one process.
+// Pushing never allocates; readers copy out under the same short lock.
+class LogRing {
+public:
+    static constexpr size_t capacity = 64;
+
+    void push(const LogRecord& record) {
+        std::lock_guard<std::mutex> lock(mtx);
+        records[total % capacity] = record;
+        total++;
+    }
+
+    // Oldest first
+    std::vector<LogRecord> snapshot() const {
+        std::lock_guard<std::mutex> lock(mtx);
+        size_t count = total < capacity ? total : capacity;
+        std::vector<LogRecord> out;
+        out.reserve(count);
+        for (uint64_t i = total - count; i < total; ++i) {
+            out.push_back(records[i % capacity]);
+        }
+        return out;
+    }
+
+    // Inverse of snapshot(): records oldest first, total ever pushed
+    void restore(const std::vector<LogRecord>& kept, uint64_t pushed) {
+        std::lock_guard<std::mutex> lock(mtx);
+        total = pushed;
+        uint64_t first = pushed - kept.size();
+        for (size_t i = 0; i < kept.size(); ++i) {
+            records[(first + i) % capacity] = kept[i];
+        }
+    }
+
+    uint64_t size() const {
+        std::lock_guard<std::mutex> lock(mtx);
+        return total;
+    }
+
+private:
+    mutable std::mutex mtx;
+    std::array<LogRecord, capacity> records{};
+    uint64_t total = 0;
+};
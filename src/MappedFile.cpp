@@ -0,0 +1,51 @@
+#include "MappedFile.h"
+#include <fstream>
+#include <iterator>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+void MappedFile::close() {
+#ifndef _WIN32
+    if (mapped) ::munmap(const_cast<uint8_t*>(bytes), length);
+#endif
+    mapped = false;
+    bytes = nullptr;
+    length = 0;
+    buffer.clear();
+}
+
+bool MappedFile::open(const std::string& filename) {
+    close();
+
+#ifndef _WIN32
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat info;
+    if (::fstat(fd, &info) == 0 && info.st_size > 0) {
+        void* view = ::mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (view != MAP_FAILED) {
+            bytes = static_cast<const uint8_t*>(view);
+            length = static_cast<size_t>(info.st_size);
+            mapped = true;
+        }
+    }
+    ::close(fd);
+    if (mapped) return true;
+#endif
+
+    std::ifstream in(filename, std::ios::binary);
+    if (!in.is_open()) return false;
+    buffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    bytes = buffer.data();
+    length = buffer.size();
+    return true;
+}
@@ -1,4 +1,5 @@
 #include "MemoryManager.h"
+#include "TimeFormat.h"
 #include <algorithm>
 #include <iostream>
 #include <iomanip>
@@ -12,6 +13,10 @@ void FirstFitMemoryAllocator::init(int maxMemory, int frameSize, int /*procLimit
     memory.clear();
     pageTables.clear();
     fifoQueue.clear();
+    pageStats.clear();
+    usedFrames = 0;
+    pageIns = 0;
+    pageOuts = 0;
 
     for (int i = 0; i < totalFrames; ++i) {
         memory.emplace_back(i);
@@ -51,6 +56,7 @@ bool FirstFitMemoryAllocator::allocate(const std::shared_ptr<Process>& proc) {
         auto free = findAnyFreeFrames(1);
         if (!free.empty()) {
             frameIndex = free[0];
+            usedFrames++;
         } else {
             // No free frame — perform FIFO replacement
             if (fifoQueue.empty()) {
@@ -79,6 +85,8 @@ bool FirstFitMemoryAllocator::allocate(const std::shared_ptr<Process>& proc) {
 
             // Count as page out
             pageOuts++;
+            pageStats[victimPid].evictions++;
+            if (pageEventHandler) pageEventHandler(PageEvent::PageOut, victimPid, victimVPage, frameIndex);
 
             // Mark frame as available
             memory[frameIndex].ownerPid = -1;
@@ -102,6 +110,8 @@ bool FirstFitMemoryAllocator::allocate(const std::shared_ptr<Process>& proc) {
 
         // Count as page in
         pageIns++;
+        pageStats[proc->pid].faults++;
+        if (pageEventHandler) pageEventHandler(PageEvent::PageIn, proc->pid, i, frameIndex);
     }
 
     if (store.is_open()) {
@@ -125,11 +135,13 @@ void FirstFitMemoryAllocator::deallocate(const std::shared_ptr<Process>& proc) {
         if (frame.ownerPid == proc->pid) {
             frame.ownerPid = -1;
             frame.virtualPage = -1;
+            usedFrames--;
         }
     }
 
     // Remove from page table
     pageTables.erase(proc->pid);
+    pageStats.erase(proc->pid);
 
     std::ofstream store(backingStoreFile, std::ios::app);
 if (store.is_open()) {
@@ -146,25 +158,28 @@ bool FirstFitMemoryAllocator::isAllocated(const ProcessPtr& process) const {
     return isAllocated(process->pid);
 }
 
+ProcessPageStats FirstFitMemoryAllocator::getPageStats(int pid) const {
+    ProcessPageStats stats;
+    auto it = pageStats.find(pid);
+    if (it != pageStats.end()) stats = it->second;
+    auto table = pageTables.find(pid);
+    stats.residentPages = table != pageTables.end() ? static_cast<int>(table->second.size()) : 0;
+    return stats;
+}
+
 void FirstFitMemoryAllocator::dumpStatusToFile(int quantumCycle) const {
     std::filesystem::create_directories("output");
     std::ofstream file("output/memory_stamp_" + std::to_string(quantumCycle) + ".txt");
     if (!file.is_open()) return;
 
     // Timestamp
-    auto now = std::chrono::system_clock::now();
-    auto time_t = std::chrono::system_clock::to_time_t(now);
-    std::stringstream ss;
-    ss << std::put_time(std::localtime(&time_t), "%Y-%m-%d %H:%M:%S ");
-    file << "Timestamp: " << ss.str() << "\n";
+    file << "Timestamp: " << TimeFormat::now(TimeFormat::Style::Stamp) << " \n";
 
     // Memory summary
-    int usedFrames = 0;
     std::set<int> activePIDs;
 
     for (const auto& frame : memory) {
         if (frame.ownerPid != -1) {
-            usedFrames++;
             activePIDs.insert(frame.ownerPid);
         }
     }
@@ -252,12 +267,18 @@ int FirstFitMemoryAllocator::ensurePageMapped(int pid, int virtualPage, std::str
               << " from frame=" << freeFrame << "\n";
 
         pageTables[victimPid].erase(victimPage);
+        pageStats[victimPid].evictions++;
+        if (pageEventHandler) pageEventHandler(PageEvent::PageOut, victimPid, victimPage, freeFrame);
+    } else {
+        usedFrames++;
     }
 
     memory[freeFrame].ownerPid = pid;
     memory[freeFrame].virtualPage = virtualPage;
     pt[virtualPage] = freeFrame;
     fifoQueue.push_back(freeFrame);
+    pageStats[pid].faults++;
+    if (pageEventHandler) pageEventHandler(PageEvent::PageIn, pid, virtualPage, freeFrame);
 
     return freeFrame;
 }
@@ -270,10 +291,8 @@ int FirstFitMemoryAllocator::findFreeFrame() {
 }
 
 void FirstFitMemoryAllocator::markAccessViolation(std::string& errOut, uint16_t badAddr) {
-    auto now = std::chrono::system_clock::now();
-    auto time_t = std::chrono::system_clock::to_time_t(now);
     std::stringstream ss;
-    ss << std::put_time(std::localtime(&time_t), "%H:%M:%S");
+    ss << TimeFormat::now(TimeFormat::Style::Clock);
     ss << " | Memory access violation at address 0x"
        << std::hex << badAddr;
     errOut = ss.str();
@@ -291,3 +310,70 @@ int FirstFitMemoryAllocator::getPageOuts() const {
     return pageOuts;
 }
 
+
+void FirstFitMemoryAllocator::saveState(BinaryWriter& out) const {
+    out.u32(static_cast<uint32_t>(totalFrames));
+    for (const auto& frame : memory) {
+        out.u32(static_cast<uint32_t>(frame.ownerPid));
+        out.u32(static_cast<uint32_t>(frame.virtualPage));
+    }
+
+    // Page tables follow from the frames; only which pids hold an allocation is extra
+    out.varint(pageTables.size());
+    for (const auto& [pid, table] : pageTables) out.svarint(pid);
+
+    out.varint(fifoQueue.size());
+    for (int frame : fifoQueue) out.varint(static_cast<uint64_t>(frame));
+
+    out.varint(pageStats.size());
+    for (const auto& [pid, stats] : pageStats) {
+        out.svarint(pid);
+        out.varint(static_cast<uint64_t>(stats.faults));
+        out.varint(static_cast<uint64_t>(stats.evictions));
+    }
+    out.varint(static_cast<uint64_t>(pageIns));
+    out.varint(static_cast<uint64_t>(pageOuts));
+}
+
+bool FirstFitMemoryAllocator::loadState(BinaryReader& in) {
+    if (static_cast<int>(in.u32()) != totalFrames) return false;
+
+    pageTables.clear();
+    usedFrames = 0;
+    std::vector<std::pair<int, int>> owned; // (pid, frame) until the pid list is read
+    for (auto& frame : memory) {
+        frame.ownerPid = static_cast<int32_t>(in.u32());
+        frame.virtualPage = static_cast<int32_t>(in.u32());
+        if (frame.ownerPid != -1) {
+            usedFrames++;
+            owned.emplace_back(frame.ownerPid, frame.frameId);
+        }
+    }
+
+    uint64_t allocated = in.varint();
+    for (uint64_t i = 0; i < allocated && !in.failed(); ++i) {
+        pageTables[static_cast<int>(in.svarint())];
+    }
+    for (const auto& [pid, frame] : owned) {
+        pageTables[pid][memory[frame].virtualPage] = frame;
+    }
+
+    fifoQueue.clear();
+    uint64_t queued = in.varint();
+    for (uint64_t i = 0; i < queued && !in.failed(); ++i) {
+        uint64_t frame = in.varint();
+        if (frame >= static_cast<uint64_t>(totalFrames)) return false;
+        fifoQueue.push_back(static_cast<int>(frame));
+    }
+
+    pageStats.clear();
+    uint64_t tracked = in.varint();
+    for (uint64_t i = 0; i < tracked && !in.failed(); ++i) {
+        ProcessPageStats& stats = pageStats[static_cast<int>(in.svarint())];
+        stats.faults = static_cast<int>(in.varint());
+        stats.evictions = static_cast<int>(in.varint());
+    }
+    pageIns = static_cast<int>(in.varint());
+    pageOuts = static_cast<int>(in.varint());
+    return !in.failed();
+}
@@ -11,6 +11,9 @@
 #include <sstream>
 #include <deque>
 #include <algorithm>
+#include <functional>
+#include <unordered_map>
+#include "BinaryIO.h"
 #include "Process.h"
 
 class MemoryFrame {
@@ -23,7 +26,19 @@ public:
     MemoryFrame(int id) : frameId(id) {}
 };
 
+// Page traffic attributed to one process while it holds memory
+struct ProcessPageStats {
+    int faults = 0;        // pages brought in for it
+    int evictions = 0;     // its pages taken by someone else
+    int residentPages = 0;
+};
+
 class FirstFitMemoryAllocator {
+public:
+    enum class PageEvent { PageIn, PageOut };
+    // Observer for page traffic: (event, owner pid, virtual page, frame)
+    using PageEventHandler = std::function<void(PageEvent, int, int, int)>;
+
 private:
     std::vector<MemoryFrame> memory;
     int memPerFrame;
@@ -31,13 +46,18 @@ private:
     int totalMemory;
     int pageIns = 0;
     int pageOuts = 0;
+    int usedFrames = 0; // kept in step with ownerPid so usage queries don't scan
     
     std::map<int, std::map<int, int>> pageTables; // pid -> {virtualPage -> frameId}
     std::deque<int> fifoQueue; // for FIFO page replacement
+    std::unordered_map<int, ProcessPageStats> pageStats; // pid -> counters (residentPages unused)
 
     std::string backingStoreFile = "csopesy-backing-store.txt";
 
+    PageEventHandler pageEventHandler;
+
 public:
+    void setPageEventHandler(PageEventHandler handler) { pageEventHandler = std::move(handler); }
 
     void init(int maxMemory, int frameSize, int procLimit);
     std::vector<int> findAnyFreeFrames(int count);
@@ -45,6 +65,7 @@ public:
     void deallocate(const std::shared_ptr<Process>& proc);
     bool isAllocated(int pid) const;
     bool isAllocated(const ProcessPtr& process) const;
+    ProcessPageStats getPageStats(int pid) const;
     void dumpStatusToFile(int quantumCycle) const;
     bool writeMemory(int pid, uint16_t address, uint16_t value, std::string& errOut);
     bool readMemory(int pid, uint16_t address, uint16_t& outValue, std::string& errOut);
@@ -53,23 +74,17 @@ public:
     void markAccessViolation(std::string& errOut, uint16_t badAddr);
     bool isValidAddress(uint32_t addr);
 
+    // Frame table, page tables, FIFO order and counters, for checkpoints.
+    // loadState expects init() with the same geometry to have run.
+    void saveState(BinaryWriter& out) const;
+    bool loadState(BinaryReader& in);
+
     int getPageIns() const;
     int getPageOuts() const;
 
     int getMemPerFrame() const { return memPerFrame; }
     int getTotalMemory() const { return totalMemory; }
-    int getUsedMemory() const {
-        int used = 0;
-        for (const auto& frame : memory) {
-            if (frame.ownerPid != -1) used++;
-        }
-        return used * memPerFrame;
-    }
-    int getFreeMemory() const {
-        int free = 0;
-        for (const auto& frame : memory) {
-            if (frame.ownerPid == -1) free++;
-        }
-        return free * memPerFrame;
-    }
+    int getUsedMemory() const { return usedFrames * memPerFrame; }
+    int getFreeMemory() const { return (totalFrames - usedFrames) * memPerFrame; }
+    int getFreeFrames() const { return totalFrames - usedFrames; }
 };
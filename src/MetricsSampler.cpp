@@ -0,0 +1,142 @@
+#include "MetricsSampler.h"
+#include "BinaryIO.h"
+#include <chrono>
+#include <iterator>
+
+namespace {
+
+constexpr uint32_t magic = 0x534D5343; // "CSMS"
+constexpr uint32_t version = 1;
+
+constexpr const char* columnNames[] = {
+    "tick", "used_memory", "free_frames", "page_ins", "page_outs", "ready_queue", "active_cores", "finished",
+};
+
+constexpr uint64_t MetricsSample::* columns[] = {
+    &MetricsSample::tick, &MetricsSample::usedMemory, &MetricsSample::freeFrames, &MetricsSample::pageIns,
+    &MetricsSample::pageOuts, &MetricsSample::readyQueue, &MetricsSample::activeCores, &MetricsSample::finished,
+};
+
+bool endsWith(const std::string& text, const std::string& suffix) {
+    return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+} // namespace
+
+MetricsSampler::~MetricsSampler() {
+    stop();
+}
+
+bool MetricsSampler::start(const std::string& file, uint64_t sampleInterval, uint64_t startTick) {
+    if (isEnabled() || sampleInterval == 0) return false;
+
+    binary = endsWith(file, ".bin");
+    out.open(file, binary ? std::ios::binary | std::ios::trunc : std::ios::trunc);
+    if (!out.is_open()) return false;
+
+    if (binary) {
+        BinaryWriter header;
+        header.u32(magic);
+        header.u32(version);
+        header.varint(sampleInterval);
+        header.varint(std::size(columnNames));
+        for (const char* name : columnNames) header.str(name);
+        header.appendTo(out);
+    } else {
+        for (size_t i = 0; i < std::size(columnNames); ++i) {
+            out << (i ? "," : "") << columnNames[i];
+        }
+        out << "\n";
+    }
+
+    filename = file;
+    interval = sampleInterval;
+    rows = 0;
+    dropped = 0;
+    captureNanos = 0;
+    pending.clear();
+    pending.reserve(maxBufferedRows);
+    stopping = false;
+    writer = std::thread(&MetricsSampler::writerLoop, this);
+
+    enabled = true;
+    nextTick = startTick;
+    return true;
+}
+
+void MetricsSampler::stop() {
+    if (!enabled.exchange(false)) return;
+    nextTick = std::numeric_limits<uint64_t>::max();
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stopping = true;
+    }
+    cv.notify_one();
+    writer.join();
+    out.close();
+}
+
+bool MetricsSampler::claim(uint64_t tick) {
+    uint64_t due = nextTick.load(std::memory_order_relaxed);
+    if (tick < due) return false;
+    // Next boundary after this tick, so an idle jump doesn't emit a burst of rows
+    uint64_t next = tick - tick % interval + interval;
+    return nextTick.compare_exchange_strong(due, next, std::memory_order_relaxed);
+}
+
+void MetricsSampler::push(const MetricsSample& sample, uint64_t nanos) {
+    captureNanos.fetch_add(nanos, std::memory_order_relaxed);
+    bool flush;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (pending.size() >= maxBufferedRows) {
+            dropped++;
+            return;
+        }
+        pending.push_back(sample);
+        flush = pending.size() == flushRows;
+    }
+    if (flush) cv.notify_one();
+}
+
+void MetricsSampler::writerLoop() {
+    std::vector<MetricsSample> batch;
+    batch.reserve(maxBufferedRows);
+    std::unique_lock<std::mutex> lock(mtx);
+    while (true) {
+        cv.wait_for(lock, std::chrono::seconds(1), [this] { return stopping || pending.size() >= flushRows; });
+        batch.swap(pending);
+        bool done = stopping;
+        lock.unlock();
+
+        if (!batch.empty()) {
+            writeRows(batch);
+            rows += batch.size();
+            batch.clear();
+        }
+        if (done) return;
+        lock.lock();
+    }
+}
+
+void MetricsSampler::writeRows(const std::vector<MetricsSample>& batch) {
+    if (binary) {
+        BinaryWriter block;
+        block.u32(static_cast<uint32_t>(batch.size()));
+        for (auto column : columns) {
+            for (const MetricsSample& sample : batch) block.u64(sample.*column);
+        }
+        block.appendTo(out);
+    } else {
+        std::string text;
+        for (const MetricsSample& sample : batch) {
+            for (size_t i = 0; i < std::size(columns); ++i) {
+                if (i) text += ',';
+                text += std::to_string(sample.*columns[i]);
+            }
+            text += '\n';
+        }
+        out << text;
+    }
+    out.flush();
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// One row of the metrics time series
+struct MetricsSample {
+    uint64_t tick = 0;
+    uint64_t usedMemory = 0;  // bytes
+    uint64_t freeFrames = 0;
+    uint64_t pageIns = 0;     // since the previous row
+    uint64_t pageOuts = 0;
+    uint64_t readyQueue = 0;
+    uint64_t activeCores = 0;
+    uint64_t finished = 0;    // cumulative
+};
+
+// Samples scheduler state every `interval` CPU ticks into a CSV file, or a
+// columnar binary file when the name ends in .bin:
+//
+//   u32 magic "CSMS", u32 version, varint interval, varint columns, columns x str name
+//   blocks: u32 rows, then each column as rows x u64 (little-endian)
+//
+// Whichever core crosses a sample boundary first claims it and appends one
+// row to an in-memory buffer; a background thread does all file I/O. The
+// buffer is bounded, so a stalled disk drops rows instead of growing memory.
+class MetricsSampler {
+public:
+    static constexpr size_t maxBufferedRows = 4096;
+    static constexpr size_t flushRows = 256;
+
+    ~MetricsSampler();
+
+    bool start(const std::string& filename, uint64_t interval, uint64_t startTick);
+    void stop(); // flushes everything buffered
+
+    bool isEnabled() const { return enabled.load(std::memory_order_relaxed); }
+    // Cheap check for the core loops; UINT64_MAX while disabled
+    bool isDue(uint64_t tick) const { return tick >= nextTick.load(std::memory_order_relaxed); }
+    // True for exactly one caller per sample boundary
+    bool claim(uint64_t tick);
+    void push(const MetricsSample& sample, uint64_t captureNanos);
+
+    const std::string& getFilename() const { return filename; }
+    uint64_t getRows() const { return rows; }
+    uint64_t getDropped() const { return dropped; }
+    uint64_t getCaptureNanos() const { return captureNanos; }
+
+private:
+    void writerLoop();
+    void writeRows(const std::vector<MetricsSample>& batch);
+
+    std::atomic<bool> enabled{false};
+    std::atomic<uint64_t> nextTick{std::numeric_limits<uint64_t>::max()};
+    uint64_t interval = 1;
+    bool binary = false;
+    std::string filename;
+    std::ofstream out;
+
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::vector<MetricsSample> pending; // filled by cores, swapped out by the writer
+    bool stopping = false;
+    std::thread writer;
+
+    std::atomic<uint64_t> rows{0};
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<uint64_t> captureNanos{0}; // time cores spent taking samples
+};
@@ -0,0 +1,401 @@
+#include "Optimizer.h"
+#include "Process.h"
+#include <cctype>
+#include <charconv>
+#include <climits>
+#include <memory_resource>
+#include <string_view>
+#include <unordered_map>
+
+namespace {
+
+constexpr int unknown = -1;
+
+// Literal or variable operand, as Process::getValue sees it
+struct Operand {
+    int var = -1;    // variable index; -1 for a literal
+    int value = 0;   // literal value
+    bool valid = true; // false if the literal would throw when evaluated
+};
+
+// Per-instruction facts for the variable passes
+struct Info {
+    int target = -1; // variable stored by DECLARE/ADD/SUBTRACT/READ
+    Operand a;       // ADD/SUBTRACT operands, WRITE value, PRINT operand
+    Operand b;
+    bool uses = false; // a/b are read (ADD/SUBTRACT always, PRINT/WRITE when not folded)
+    bool safeRead = false; // READ whose address can never fault
+};
+
+using State = std::vector<int>; // known value per variable, or unknown
+
+class Optimizer {
+public:
+    Optimizer(std::vector<Instruction>& program, int memorySize) : program(program), memorySize(memorySize) {}
+
+    OptimizeStats run() {
+        foldConstants();
+        if (!collectVariables()) return stats;
+
+        bool sinks = false;
+        bool readsSafe = true;
+        for (size_t i = 0; i < program.size(); ++i) {
+            const Instruction& instr = program[i];
+            if ((instr.type == InstructionType::PRINT || instr.type == InstructionType::WRITE) && info[i].uses) sinks = true;
+            if (instr.type == InstructionType::READ && info[i].target >= 0 && !info[i].safeRead) readsSafe = false;
+        }
+        // Below the limit no DECLARE or READ is ever ignored, so dropping or
+        // skipping a store cannot change which later ones take effect
+        bool fits = variableCount < static_cast<int>(Process::maxVariables);
+        if (!fits && !readsSafe) return stats;
+
+        if (!sinks) {
+            // Nothing observable reads a variable: every store is dead
+            for (size_t i = 0; i < program.size(); ++i) {
+                if (info[i].target >= 0 && (program[i].type != InstructionType::READ || info[i].safeRead)) remove(i);
+            }
+            return stats;
+        }
+        if (!fits || !structured()) return stats;
+
+        propagate();
+        eliminateDeadStores();
+        hoistInvariants();
+        return stats;
+    }
+
+private:
+    // Precomputation that is valid for any program
+    void foldConstants() {
+        for (Instruction& instr : program) {
+            switch (instr.type) {
+                case InstructionType::DECLARE:
+                    if (instr.params.size() >= 2) {
+                        try {
+                            instr.constant = static_cast<uint16_t>(std::stoi(instr.params[1]));
+                            stats.folded++;
+                        } catch (const std::exception&) {
+                        }
+                    }
+                    break;
+                case InstructionType::READ:
+                    if (instr.params.size() >= 2) foldAddress(instr, instr.params[1]);
+                    break;
+                case InstructionType::WRITE:
+                    if (instr.params.size() >= 2) {
+                        foldAddress(instr, instr.params[0]);
+                        Operand value = operand(instr.params[1], false);
+                        if (value.var < 0 && value.valid) instr.constant = value.value;
+                    }
+                    break;
+                case InstructionType::PRINT: {
+                    Operand value = printOperand(instr, false);
+                    if (value.var < 0 && value.valid) {
+                        instr.constant = value.value;
+                        stats.folded++;
+                    }
+                    break;
+                }
+                default:
+                    break;
+            }
+        }
+    }
+
+    void foldAddress(Instruction& instr, const std::string& text) {
+        try {
+            uint32_t address = Process::parseHexAddress(text);
+            if (address <= static_cast<uint32_t>(INT_MAX)) {
+                instr.memoryAddress = static_cast<int>(address);
+                stats.folded++;
+            }
+        } catch (const std::exception&) {
+        }
+    }
+
+    // Indexes every variable; false if some variable operation could throw
+    bool collectVariables() {
+        info.assign(program.size(), Info{});
+        for (size_t i = 0; i < program.size(); ++i) {
+            const Instruction& instr = program[i];
+            Info& facts = info[i];
+            switch (instr.type) {
+                case InstructionType::DECLARE:
+                    if (instr.params.size() < 2) break;
+                    if (instr.constant < 0) return false;
+                    facts.target = variable(instr.params[0]);
+                    break;
+                case InstructionType::ADD:
+                case InstructionType::SUBTRACT:
+                    if (instr.params.size() < 3) break;
+                    facts.a = operand(instr.params[1], true);
+                    facts.b = operand(instr.params[2], true);
+                    if (!facts.a.valid || !facts.b.valid) return false;
+                    facts.target = variable(instr.params[0]);
+                    facts.uses = true;
+                    break;
+                case InstructionType::READ:
+                    if (instr.params.size() < 2) break;
+                    facts.target = variable(instr.params[0]);
+                    facts.safeRead = instr.memoryAddress >= 0 && instr.memoryAddress < memorySize;
+                    break;
+                case InstructionType::WRITE:
+                    if (instr.params.size() < 2 || instr.constant >= 0) break;
+                    facts.a = operand(instr.params[1], true);
+                    if (!facts.a.valid) return false;
+                    facts.uses = facts.a.var >= 0;
+                    break;
+                case InstructionType::PRINT:
+                    if (instr.constant >= 0) break;
+                    facts.a = printOperand(instr, true);
+                    facts.uses = facts.a.var >= 0;
+                    break;
+                default:
+                    break;
+            }
+        }
+        // The keys point into params, which later passes may replace
+        variableCount = static_cast<int>(names.size());
+        names.clear();
+        return true;
+    }
+
+    int variable(std::string_view name) {
+        auto [it, added] = names.emplace(name, static_cast<int>(names.size()));
+        return it->second;
+    }
+
+    Operand operand(std::string_view text, bool index) {
+        Operand result;
+        if (!text.empty() && std::isdigit(static_cast<unsigned char>(text[0]))) {
+            int literal = 0;
+            auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), literal);
+            result.valid = ec != std::errc::result_out_of_range;
+            result.value = static_cast<uint16_t>(literal);
+        } else {
+            result.var = index ? variable(text) : 0;
+        }
+        return result;
+    }
+
+    // Same split as Process::evaluatePrint; a quoted message alone prints 0
+    Operand printOperand(const Instruction& instr, bool index) {
+        Operand result;
+        if (instr.params.empty()) {
+            result.valid = false;
+            return result;
+        }
+        std::string_view text = instr.params[0];
+        size_t first = text.find_first_not_of(" \t\n\r");
+        if (first == std::string_view::npos) {
+            text = {};
+        } else {
+            text = text.substr(first, text.find_last_not_of(" \t\n\r") - first + 1);
+        }
+        size_t plus = text.find(" + ");
+        if (plus != std::string_view::npos) return operand(text.substr(plus + 3), index);
+        if (text.size() >= 2 && text.front() == '"' && text.back() == '"') return result;
+        if (text.empty()) {
+            result.var = index ? variable(text) : 0;
+            return result;
+        }
+        return operand(text, index);
+    }
+
+    bool structured() const {
+        for (const Instruction& instr : program) {
+            if ((instr.type == InstructionType::FOR_START || instr.type == InstructionType::FOR_END) && instr.jumpTarget < 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void remove(size_t i) {
+        program[i].reset(InstructionType::NOP);
+        info[i] = Info{};
+        stats.removed++;
+    }
+
+    int valueOf(const Operand& op, const State& state) const {
+        return op.var < 0 ? op.value : state[op.var];
+    }
+
+    // Forward constant propagation. Every variable starts at 0, which is what
+    // an undeclared variable reads while the symbol table has room.
+    void propagate() {
+        states.assign(program.size(), State());
+        State state(variableCount, 0);
+        forward(0, program.size(), state);
+
+        for (size_t i = 0; i < program.size(); ++i) {
+            Instruction& instr = program[i];
+            const State& in = states[i];
+            if (in.empty()) continue;
+            Info& facts = info[i];
+            if (instr.type == InstructionType::ADD || instr.type == InstructionType::SUBTRACT) {
+                int a = valueOf(facts.a, in);
+                int b = valueOf(facts.b, in);
+                if (a == unknown || b == unknown) continue;
+                instr.constant = instr.type == InstructionType::ADD ? static_cast<uint16_t>(a + b)
+                                                                    : static_cast<uint16_t>(a - b);
+                facts.uses = false;
+                stats.folded++;
+            } else if ((instr.type == InstructionType::WRITE || instr.type == InstructionType::PRINT) && facts.uses) {
+                int value = valueOf(facts.a, in);
+                if (value == unknown) continue;
+                instr.constant = value;
+                facts.uses = false;
+                stats.folded++;
+            }
+        }
+    }
+
+    void forward(size_t begin, size_t end, State& state) {
+        for (size_t i = begin; i < end; ++i) {
+            const Instruction& instr = program[i];
+            if (instr.type == InstructionType::FOR_START) {
+                // The body runs at least once; iterate its entry state to a fixpoint
+                size_t close = static_cast<size_t>(instr.jumpTarget);
+                State head = state;
+                State body;
+                while (true) {
+                    body = head;
+                    forward(i + 1, close, body);
+                    State next = join(state, body);
+                    if (next == head) break;
+                    head = std::move(next);
+                }
+                state = std::move(body);
+                i = close;
+                continue;
+            }
+
+            states[i] = state;
+            const Info& facts = info[i];
+            if (facts.target < 0) continue;
+            switch (instr.type) {
+                case InstructionType::DECLARE:
+                    state[facts.target] = instr.constant;
+                    break;
+                case InstructionType::ADD:
+                case InstructionType::SUBTRACT: {
+                    if (instr.constant >= 0) {
+                        state[facts.target] = instr.constant;
+                        break;
+                    }
+                    int a = valueOf(facts.a, state);
+                    int b = valueOf(facts.b, state);
+                    state[facts.target] = a == unknown || b == unknown ? unknown
+                                          : instr.type == InstructionType::ADD ? static_cast<uint16_t>(a + b)
+                                                                               : static_cast<uint16_t>(a - b);
+                    break;
+                }
+                default:
+                    state[facts.target] = unknown; // READ
+                    break;
+            }
+        }
+    }
+
+    static State join(const State& a, const State& b) {
+        State result(a.size());
+        for (size_t v = 0; v < a.size(); ++v) result[v] = a[v] == b[v] ? a[v] : unknown;
+        return result;
+    }
+
+    uint64_t usesOf(size_t i) const {
+        const Info& facts = info[i];
+        if (!facts.uses) return 0;
+        uint64_t mask = 0;
+        if (facts.a.var >= 0) mask |= 1ull << facts.a.var;
+        if (facts.b.var >= 0) mask |= 1ull << facts.b.var;
+        return mask;
+    }
+
+    bool isDead(size_t i) const {
+        const Info& facts = info[i];
+        return facts.target >= 0 && !(liveAfter[i] & (1ull << facts.target)) &&
+               (program[i].type != InstructionType::READ || facts.safeRead);
+    }
+
+    void eliminateDeadStores() {
+        liveAfter.assign(program.size(), 0);
+        backward(0, program.size(), 0);
+        for (size_t i = 0; i < program.size(); ++i) {
+            if (isDead(i)) remove(i);
+        }
+    }
+
+    // Live variables before [begin, end) given those live after it. A store
+    // that turns out dead contributes no uses, so chains of them disappear.
+    uint64_t backward(size_t begin, size_t end, uint64_t live) {
+        for (size_t i = end; i-- > begin;) {
+            const Instruction& instr = program[i];
+            if (instr.type == InstructionType::FOR_END) {
+                // Leaving the body either exits or starts the next iteration
+                size_t open = static_cast<size_t>(instr.jumpTarget);
+                uint64_t atEnd = live;
+                uint64_t atStart;
+                while (true) {
+                    atStart = backward(open + 1, i, atEnd);
+                    uint64_t next = live | atStart;
+                    if (next == atEnd) break;
+                    atEnd = next;
+                }
+                live = atStart;
+                i = open;
+                continue;
+            }
+
+            liveAfter[i] = live;
+            if (isDead(i)) continue;
+            if (info[i].target >= 0) live &= ~(1ull << info[i].target);
+            live |= usesOf(i);
+        }
+        return live;
+    }
+
+    // A store inside a FOR whose target nothing else in the body writes and
+    // whose operands the body never changes leaves the same value every time
+    void hoistInvariants() {
+        for (size_t open = 0; open < program.size(); ++open) {
+            if (program[open].type != InstructionType::FOR_START) continue;
+            size_t close = static_cast<size_t>(program[open].jumpTarget);
+
+            std::vector<int> writes(variableCount, 0);
+            for (size_t i = open + 1; i < close; ++i) {
+                if (info[i].target >= 0) writes[info[i].target]++;
+            }
+            for (size_t i = open + 1; i < close; ++i) {
+                if (program[i].type == InstructionType::FOR_START) {
+                    i = static_cast<size_t>(program[i].jumpTarget); // nested bodies belong to their own loop
+                    continue;
+                }
+                const Info& facts = info[i];
+                bool store = program[i].type == InstructionType::DECLARE || program[i].type == InstructionType::ADD ||
+                             program[i].type == InstructionType::SUBTRACT;
+                if (!store || facts.target < 0 || writes[facts.target] != 1) continue;
+                if ((facts.a.var >= 0 && writes[facts.a.var]) || (facts.b.var >= 0 && writes[facts.b.var])) continue;
+                program[i].firstPassOnly = true;
+                stats.hoisted++;
+            }
+        }
+    }
+
+    std::vector<Instruction>& program;
+    int memorySize;
+    OptimizeStats stats;
+    std::pmr::monotonic_buffer_resource scratch;
+    std::pmr::unordered_map<std::string_view, int> names{&scratch}; // only while collecting
+    int variableCount = 0;
+    std::vector<Info> info;
+    std::vector<State> states;     // constants known before each instruction
+    std::vector<uint64_t> liveAfter; // variables live after each instruction
+};
+
+} // namespace
+
+OptimizeStats optimizeProgram(std::vector<Instruction>& program, int memorySize) {
+    return Optimizer(program, memorySize).run();
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include "Instruction.h"
+
+// Optional pass (config `optimize 1`) over generated programs and compiled
+// screen -c programs, run on the instruction list before assembleProgram. Every instruction still retires in its own cycle and
+// FOR blocks keep their shape, so instruction counts, progress and schedules
+// are exactly those of the unoptimized program; only host work per cycle
+// shrinks.
+//
+//   folding    addresses, DECLARE values and PRINT/WRITE operands are
+//              precomputed into Instruction::constant / memoryAddress, and
+//              ADD/SUBTRACT of known values become a DECLARE of the result
+//   dead code  stores nothing observable reads (through PRINT or WRITE)
+//              become NOPs
+//   hoisting   a store whose operands a FOR body never changes runs on the
+//              body's first iteration only (Instruction::firstPassOnly)
+//
+// Variable rewrites need the symbol-table limit out of the way: either every
+// variable fits in it, or no variable is ever printed or written and no READ
+// can fault. Programs that could throw at run time keep their variable
+// operations untouched.
+struct OptimizeStats {
+    int removed = 0; // dead stores turned into NOPs
+    int folded = 0;  // operands or results precomputed
+    int hoisted = 0; // loop-invariant stores limited to the first iteration
+};
+
+// memorySize 0 means unknown (images shared across processes); READs are then
+// assumed able to fault and are never removed
+OptimizeStats optimizeProgram(std::vector<Instruction>& program, int memorySize);
@@ -0,0 +1,32 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+
+// Deadline-based pacing for delays-per-exec. Each core owns one; the worker
+// only sleeps when every core it drives is ahead of its deadline, so wake-up
+// overshoot is paid back by running the overdue instructions back to back.
+class CorePacer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Cap on how far a core may fall behind before we stop trying to catch up
+    // (e.g. after sitting idle, or on an overloaded host)
+    static constexpr auto maxLag = std::chrono::milliseconds(100);
+
+    void setPeriod(Clock::duration p) { period = p; }
+    bool isEnabled() const { return period.count() > 0; }
+
+    bool isDue(Clock::time_point now) const { return now >= deadline; }
+    Clock::time_point nextDeadline() const { return deadline; }
+
+    void onExecuted(Clock::time_point now) {
+        if (deadline + std::max<Clock::duration>(maxLag, period) < now) {
+            deadline = now;
+        }
+        deadline += period;
+    }
+
+private:
+    Clock::duration period{0};
+    Clock::time_point deadline{};
+};
@@ -1,10 +1,15 @@
 #pragma once
-#include "Instruction.h"
+#include "LogRing.h"
+#include "Program.h"
+#include "SparseMemory.h"
 #include <string>
+#include <string_view>
 #include <vector>
-#include <map>
 #include <memory>
+#include <memory_resource>
+#include <cstddef>
 #include <cstdint>
+#include <chrono>
 
 class Process {
 public:
@@ -13,54 +18,147 @@ public:
     int memorySize; // bytes allocated to this process
     int totalInstructions;
     int currentInstruction;
-    std::string creationTime;
-    std::string finishTime;
+    std::chrono::system_clock::time_point creationTime;
+    std::chrono::system_clock::time_point finishTime;
     int assignedCore;
     bool isFinished;
 
     bool accessViolation;
     std::string invalidAccess;
 
-    // Memory and variables
-    std::vector<uint8_t> memory;
+    // Everything that lives exactly as long as the process (its own program
+    // image, symbol table, loop stacks, preemption history and memory pages)
+    // is carved from this arena, starting in the inline buffer, and released
+    // in one piece when the process goes
+    static constexpr size_t arenaInlineBytes = 1024;
+    alignas(std::max_align_t) std::byte arenaBuffer[arenaInlineBytes];
+    std::pmr::monotonic_buffer_resource arena;
+
+    // Memory and variables; pages are allocated when first written
+    SparseMemory memory;
     static constexpr size_t maxVariables = 32; // 32 variables * 2 bytes = 64 bytes
 
-    std::vector<std::string> printLogs;
-    std::vector<Instruction> instructions;
-    std::map<std::string, uint16_t> variables; // symbol table: name -> value
+    LogRing printLogs;
+    std::string faultMessage; // text for a LogKind::Error record
+    ProgramPtr program; // never null; shared between processes
+    // Symbol table, indexed by the program's variable slots: the value, or -1
+    // while the variable has not been created
+    std::pmr::vector<int32_t> variables{&arena};
+    size_t variableCount = 0;
 
     // Round-robin scheduling variables
     int remainingQuantum;
     int sleepCounter;
     bool isSleeping;
+
+    // Scheduling timestamps in CPU ticks, kept by the scheduler
+    static constexpr uint64_t noTick = UINT64_MAX;
+    uint64_t arrivalTick = 0;
+    uint64_t firstDispatchTick = noTick;
+    uint64_t readySinceTick = 0;     // last time it entered the ready queue
+    uint64_t finishTick = noTick;
+    uint64_t readyWaitTicks = 0;     // total time spent in the ready queue
+    std::pmr::vector<uint64_t> preemptTicks{&arena};
+
+    // Resource accounting (page counters live in the allocator)
+    uint64_t cpuTicks = 0;        // cycles spent on a core, sleeping included
+    uint64_t sleepTicks = 0;
+    uint64_t contextSwitches = 0; // dispatches onto a core
     
     // For loop handling
-    std::vector<int> forLoopStack;
-    std::vector<int> forLoopCounters;
+    std::pmr::vector<int> forLoopStack{&arena};
+    std::pmr::vector<int> forLoopCounters{&arena};
     
 
     Process(const std::string& processName, int pid, int memorySize);
     
-    void generateRandomInstructions(int minIns, int maxIns);
     bool executeNextInstruction(int coreId);
-    std::string getCurrentTimestamp() const;
     
     // new
     bool parseUserInstructions(const std::string& instructionString);
-    bool parseInstruction(const std::string& instrStr, Instruction& instr);
+    void setProgram(ProgramPtr image);
+    // Moves a program only this process runs into its arena; the image must
+    // not be handed to anything that outlives the process
+    ProgramPtr adoptProgram(Program&& image);
     
     // new Memory operations
-    uint32_t parseHexAddress(const std::string& hexStr);
+    static uint32_t parseHexAddress(const std::string& hexStr);
     bool isValidAddress(uint32_t address);
     uint16_t readFromMemory(uint32_t address);
     void writeToMemory(uint32_t address, uint16_t value);
     void handleMemoryAccessViolation(uint32_t address);
     
     // new Print processing
-    std::string processPrintStatement(const std::string& statement);
+    std::string formatLogRecord(const LogRecord& record) const;
+    std::vector<std::string> formatLogs() const;
 
 private:
-    uint16_t getValue(const std::string& param);
+    // Value of an operand slot; a missing variable reads 0 and is created if there is room
+    uint16_t load(uint16_t slot) {
+        int32_t value = variables[slot];
+        if (value >= 0) return static_cast<uint16_t>(value);
+        if (variableCount < maxVariables) {
+            variables[slot] = 0;
+            variableCount++;
+        }
+        return 0;
+    }
+    void store(uint16_t slot, uint16_t value) {
+        if (variables[slot] < 0) variableCount++;
+        variables[slot] = value;
+    }
+    bool handleFault(int coreId, std::string_view message); // FAULT op: log the error and stop
 };
 
-using ProcessPtr = std::shared_ptr<Process>;
\ No newline at end of file
+using ProcessPtr = std::shared_ptr<Process>;
+
+enum class ExitReason {
+    None,            // still running or waiting
+    Completed,
+    AccessViolation,
+    Error,
+};
+
+// Point-in-time copy of the fields reports need, so formatting can happen
+// after the scheduler lock has been released
+struct ProcessSummary {
+    std::string name;
+    int pid = -1;
+    int memorySize = 0;
+    std::chrono::system_clock::time_point creationTime;
+    std::chrono::system_clock::time_point finishTime;
+    int assignedCore = -1;
+    int currentInstruction = 0;
+    int totalInstructions = 0;
+    bool memoryAllocated = false;
+    ExitReason exitReason = ExitReason::None;
+    std::string invalidAccess; // hex address, AccessViolation only
+
+    uint64_t cpuTicks = 0;
+    uint64_t sleepTicks = 0;
+    uint64_t contextSwitches = 0;
+    uint64_t preemptions = 0;
+    int pageFaults = 0;        // filled in by the scheduler from the allocator
+    int evictions = 0;
+    int residentBytes = 0;
+
+    ProcessSummary() = default;
+    explicit ProcessSummary(const Process& process)
+        : name(process.name), pid(process.pid), memorySize(process.memorySize),
+          creationTime(process.creationTime), finishTime(process.finishTime),
+          assignedCore(process.assignedCore), currentInstruction(process.currentInstruction),
+          totalInstructions(process.totalInstructions), cpuTicks(process.cpuTicks),
+          sleepTicks(process.sleepTicks), contextSwitches(process.contextSwitches),
+          preemptions(process.preemptTicks.size()) {
+        if (process.isFinished) {
+            if (process.accessViolation) {
+                exitReason = ExitReason::AccessViolation;
+                invalidAccess = process.invalidAccess;
+            } else if (process.currentInstruction < process.totalInstructions) {
+                exitReason = ExitReason::Error;
+            } else {
+                exitReason = ExitReason::Completed;
+            }
+        }
+    }
+};
\ No newline at end of file
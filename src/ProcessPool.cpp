@@ -0,0 +1,101 @@
+#include "ProcessPool.h"
+#include <mutex>
+#include <new>
+
+namespace {
+
+constexpr size_t blocksPerSlab = 32;
+
+// Free list of equal-sized blocks. Slabs are cut up lazily, so a block taken
+// from the list is always one that held a process before.
+class BlockPool {
+public:
+    void* allocate(size_t size) {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (blockSize == 0) blockSize = roundUp(size);
+        if (size > blockSize) return ::operator new(size);
+
+        stats.live++;
+        if (freeList) {
+            FreeBlock* block = freeList;
+            freeList = block->next;
+            stats.recycled++;
+            return block;
+        }
+        if (fresh == slabEnd) {
+            fresh = static_cast<char*>(::operator new(blockSize * blocksPerSlab));
+            slabEnd = fresh + blockSize * blocksPerSlab;
+            stats.slabs++;
+        }
+        void* block = fresh;
+        fresh += blockSize;
+        return block;
+    }
+
+    void deallocate(void* pointer, size_t size) {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (size > blockSize) {
+            ::operator delete(pointer);
+            return;
+        }
+        stats.live--;
+        freeList = new (pointer) FreeBlock{freeList};
+    }
+
+    ProcessPool::Stats getStats() {
+        std::lock_guard<std::mutex> lock(mtx);
+        return stats;
+    }
+
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    static size_t roundUp(size_t size) {
+        constexpr size_t align = alignof(std::max_align_t);
+        return (size + align - 1) / align * align;
+    }
+
+    std::mutex mtx;
+    size_t blockSize = 0; // fixed by the first request: the control block with its Process
+    FreeBlock* freeList = nullptr;
+    char* fresh = nullptr;
+    char* slabEnd = nullptr;
+    ProcessPool::Stats stats;
+};
+
+// Never destroyed, so processes still referenced during static teardown can
+// give their blocks back
+BlockPool& pool() {
+    static BlockPool* instance = new BlockPool();
+    return *instance;
+}
+
+template <typename T>
+struct PoolAllocator {
+    static_assert(alignof(T) <= alignof(std::max_align_t), "pool blocks are max_align_t aligned");
+    using value_type = T;
+
+    PoolAllocator() = default;
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>&) {}
+
+    T* allocate(size_t n) { return static_cast<T*>(pool().allocate(n * sizeof(T))); }
+    void deallocate(T* pointer, size_t n) { pool().deallocate(pointer, n * sizeof(T)); }
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U>&) const { return true; }
+    template <typename U>
+    bool operator!=(const PoolAllocator<U>&) const { return false; }
+};
+
+} // namespace
+
+ProcessPool::Stats ProcessPool::getStats() {
+    return pool().getStats();
+}
+
+ProcessPtr ProcessPool::make(const std::string& name, int pid, int memorySize) {
+    return std::allocate_shared<Process>(PoolAllocator<Process>(), name, pid, memorySize);
+}
@@ -0,0 +1,20 @@
+#pragma once
+#include "Process.h"
+#include <cstddef>
+#include <string>
+
+// Processes are created through here rather than make_shared: the Process and
+// its shared_ptr control block share one fixed-size block carved from a slab,
+// and when the last reference drops the block goes on a free list for the
+// next process instead of back to the heap.
+class ProcessPool {
+public:
+    struct Stats {
+        size_t slabs = 0;    // slabs taken from the heap; never returned
+        size_t live = 0;     // blocks holding a process
+        size_t recycled = 0; // processes placed in a block used before
+    };
+    static Stats getStats();
+
+    static ProcessPtr make(const std::string& name, int pid, int memorySize);
+};
@@ -0,0 +1,202 @@
+#include "Program.h"
+#include "Process.h"
+#include <cctype>
+#include <charconv>
+#include <cstddef>
+#include <string_view>
+#include <unordered_map>
+
+namespace {
+
+constexpr size_t maxSlots = 65536;
+
+class Assembler {
+public:
+    Assembler(Program& out, std::pmr::memory_resource* scratch) : out(out), slots(scratch), strings(scratch) {}
+
+    void add(const Instruction& instr) {
+        Op op;
+        if (instr.firstPassOnly) op.flags |= Op::FirstPassOnly;
+        bool ok = true;
+        switch (instr.type) {
+            case InstructionType::PRINT:
+                ok = print(instr, op);
+                break;
+            case InstructionType::DECLARE:
+                if (instr.params.size() < 2) break;
+                op.code = OpCode::DECLARE;
+                ok = slot(instr.params[0], op.a) && declareValue(instr, op.b);
+                break;
+            case InstructionType::ADD:
+            case InstructionType::SUBTRACT:
+                if (instr.params.size() < 3) break;
+                if (instr.constant >= 0) {
+                    op.code = OpCode::SET;
+                    op.b = static_cast<uint16_t>(instr.constant);
+                    ok = slot(instr.params[0], op.a);
+                    break;
+                }
+                op.code = instr.type == InstructionType::ADD ? OpCode::ADD : OpCode::SUBTRACT;
+                ok = slot(instr.params[0], op.a) && operand(instr.params[1], op, op.b, Op::LiteralB) &&
+                     operand(instr.params[2], op, op.c, Op::LiteralC);
+                break;
+            case InstructionType::READ:
+                if (instr.params.size() < 2) break;
+                op.code = OpCode::READ;
+                ok = slot(instr.params[0], op.a) && address(instr, instr.params[1], op);
+                break;
+            case InstructionType::WRITE:
+                if (instr.params.size() < 2) break;
+                op.code = OpCode::WRITE;
+                ok = address(instr, instr.params[0], op);
+                if (ok && instr.constant >= 0) {
+                    op.a = static_cast<uint16_t>(instr.constant);
+                    op.flags |= Op::LiteralA;
+                } else if (ok) {
+                    ok = operand(instr.params[1], op, op.a, Op::LiteralA);
+                }
+                break;
+            case InstructionType::SLEEP:
+                op.code = OpCode::SLEEP;
+                op.setWide(static_cast<uint32_t>(instr.sleepCycles));
+                break;
+            case InstructionType::FOR_START:
+                op.code = OpCode::FOR_START;
+                op.setWide(static_cast<uint32_t>(instr.forRepeats));
+                break;
+            case InstructionType::FOR_END:
+                op.code = OpCode::FOR_END;
+                if (instr.jumpTarget >= 0) {
+                    op.setWide(static_cast<uint32_t>(instr.jumpTarget));
+                    op.flags |= Op::HasTarget;
+                }
+                break;
+            case InstructionType::NOP:
+                break;
+        }
+        if (!ok) {
+            op = Op{};
+            op.code = OpCode::FAULT;
+            op.setWide(static_cast<uint32_t>(out.strings.size()));
+            out.strings.emplace_back(error);
+        }
+        out.ops.push_back(op);
+    }
+
+private:
+    bool fail(std::string message) {
+        error = std::move(message);
+        return false;
+    }
+
+    bool slot(std::string_view name, uint16_t& index) {
+        auto it = slots.find(name);
+        if (it == slots.end()) {
+            if (out.names.size() >= maxSlots) return fail("too many variables");
+            it = slots.emplace(name, static_cast<uint16_t>(out.names.size())).first;
+            out.names.emplace_back(name);
+        }
+        index = it->second;
+        return true;
+    }
+
+    uint32_t string(std::string_view text) {
+        auto [it, added] = strings.emplace(text, static_cast<uint32_t>(out.strings.size()));
+        if (added) out.strings.emplace_back(text);
+        return it->second;
+    }
+
+    static bool isLiteral(std::string_view text) {
+        return !text.empty() && std::isdigit(static_cast<unsigned char>(text[0]));
+    }
+
+    // Same conversion as evaluating the literal at run time; false if that throws
+    static bool literal(std::string_view text, uint16_t& value) {
+        int parsed = 0;
+        auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), parsed);
+        value = static_cast<uint16_t>(parsed);
+        return ec != std::errc::result_out_of_range;
+    }
+
+    // Literal or variable, read the way Process evaluates operands
+    bool operand(std::string_view text, Op& op, uint16_t& field, uint8_t literalFlag) {
+        if (!isLiteral(text)) return slot(text, field);
+        if (!literal(text, field)) return fail("literal out of range");
+        op.flags |= literalFlag;
+        return true;
+    }
+
+    bool declareValue(const Instruction& instr, uint16_t& value) {
+        if (instr.constant >= 0) {
+            value = static_cast<uint16_t>(instr.constant);
+            return true;
+        }
+        try {
+            value = static_cast<uint16_t>(std::stoi(instr.params[1]));
+            return true;
+        } catch (const std::exception& e) {
+            return fail(e.what());
+        }
+    }
+
+    bool address(const Instruction& instr, const std::string& text, Op& op) {
+        if (instr.memoryAddress >= 0) {
+            op.setWide(static_cast<uint32_t>(instr.memoryAddress));
+            return true;
+        }
+        try {
+            op.setWide(Process::parseHexAddress(text));
+            return true;
+        } catch (const std::exception& e) {
+            return fail(e.what());
+        }
+    }
+
+    // "text" prints no value, "text" + operand and a bare operand print one;
+    // a bare literal too large to evaluate prints the unknown-format message
+    bool print(const Instruction& instr, Op& op) {
+        op.code = OpCode::PRINT;
+        std::string_view text = instr.params.empty() ? std::string_view() : std::string_view(instr.params[0]);
+        size_t first = text.find_first_not_of(" \t\n\r");
+        text = first == std::string_view::npos
+                   ? std::string_view()
+                   : text.substr(first, text.find_last_not_of(" \t\n\r") - first + 1);
+        op.setWide(string(text));
+
+        if (instr.constant >= 0) {
+            op.a = static_cast<uint16_t>(instr.constant);
+            op.flags |= Op::LiteralA;
+            return true;
+        }
+        size_t plus = text.find(" + ");
+        if (plus != std::string_view::npos) return operand(text.substr(plus + 3), op, op.a, Op::LiteralA);
+        if (text.size() >= 2 && text.front() == '"' && text.back() == '"') {
+            op.flags |= Op::LiteralA;
+            return true;
+        }
+        if (!isLiteral(text)) return slot(text, op.a);
+        op.flags |= literal(text, op.a) ? Op::LiteralA : Op::UnknownA;
+        return true;
+    }
+
+    Program& out;
+    std::string error;
+    // Keys view the source instructions, which outlive the assembler
+    std::pmr::unordered_map<std::string_view, uint16_t> slots;
+    std::pmr::unordered_map<std::string_view, uint32_t> strings;
+};
+
+} // namespace
+
+Program assembleProgram(const std::vector<Instruction>& instructions, std::pmr::memory_resource* arena) {
+    Program program(arena);
+    program.ops.reserve(instructions.size());
+    // The lookup tables only live for this call
+    alignas(std::max_align_t) std::byte buffer[4096];
+    std::pmr::monotonic_buffer_resource scratch(buffer, sizeof(buffer));
+    Assembler assembler(program, &scratch);
+    for (const Instruction& instr : instructions) {
+        assembler.add(instr);
+    }
+    return program;
+}
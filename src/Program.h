@@ -0,0 +1,79 @@
+#pragma once
+#include "Instruction.h"
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+// Executable form of an instruction stream: one 8-byte Op per instruction in
+// a single array, with variable names and PRINT text in side tables. Variables
+// are numbered slots, so the interpreter indexes an array instead of looking
+// names up.
+//
+//   PRINT     a operand (LiteralA / UnknownA), wide() strings index of the statement
+//   DECLARE   a slot, b value
+//   ADD/SUB   a slot, b and c operands (LiteralB / LiteralC)
+//   SET       a slot, b value (ADD/SUBTRACT folded by the optimizer)
+//   READ      a slot, wide() address
+//   WRITE     a operand (LiteralA), wide() address
+//   SLEEP     wide() cycles
+//   FOR_START wide() repeats
+//   FOR_END   wide() index of the FOR_START when HasTarget, else the loop stack
+//   FAULT     wide() strings index of the error; stands in for an instruction whose
+//             operands cannot be evaluated (builders never produce these)
+enum class OpCode : uint8_t {
+    PRINT,
+    DECLARE,
+    ADD,
+    READ,
+    WRITE,
+    SUBTRACT,
+    SLEEP,
+    FOR_START,
+    FOR_END,
+    NOP,
+    SET,
+    FAULT,
+};
+
+struct Op {
+    static constexpr uint8_t LiteralA = 1;      // a is a value, not a slot
+    static constexpr uint8_t LiteralB = 2;
+    static constexpr uint8_t LiteralC = 4;
+    static constexpr uint8_t UnknownA = 8;      // PRINT of an out-of-range literal
+    static constexpr uint8_t HasTarget = 16;
+    static constexpr uint8_t FirstPassOnly = 32;
+
+    OpCode code = OpCode::NOP;
+    uint8_t flags = 0;
+    uint16_t a = 0;
+    uint16_t b = 0;
+    uint16_t c = 0;
+
+    uint32_t wide() const { return b | static_cast<uint32_t>(c) << 16; }
+    void setWide(uint32_t value) {
+        b = static_cast<uint16_t>(value);
+        c = static_cast<uint16_t>(value >> 16);
+    }
+};
+
+static_assert(sizeof(Op) == 8, "ops are packed to 8 bytes");
+
+struct Program {
+    std::pmr::vector<Op> ops;
+    std::pmr::vector<std::pmr::string> names;   // slot -> variable name
+    std::pmr::vector<std::pmr::string> strings; // PRINT statements and FAULT messages
+
+    Program() = default;
+    explicit Program(std::pmr::memory_resource* arena) : ops(arena), names(arena), strings(arena) {}
+
+    size_t size() const { return ops.size(); }
+};
+
+// Immutable once built, so processes running the same source share one image
+using ProgramPtr = std::shared_ptr<const Program>;
+
+// Resolves operands, addresses and variable names of a built instruction list
+Program assembleProgram(const std::vector<Instruction>& instructions,
+                        std::pmr::memory_resource* arena = std::pmr::get_default_resource());
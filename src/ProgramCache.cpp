@@ -0,0 +1,51 @@
+#include "ProgramCache.h"
+#include "Optimizer.h"
+#include "ProgramParser.h"
+
+void ProgramCache::reset(size_t newCapacity, bool newOptimize) {
+    std::lock_guard<std::mutex> lock(mtx);
+    index.clear();
+    lru.clear();
+    stats = Stats{};
+    capacity = newCapacity;
+    optimize = newOptimize;
+    index.reserve(capacity);
+}
+
+ProgramPtr ProgramCache::compile(std::string_view source, std::string& error) {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        auto it = index.find(source);
+        if (it != index.end()) {
+            lru.splice(lru.begin(), lru, it->second);
+            stats.hits++;
+            return it->second->program;
+        }
+        stats.misses++;
+    }
+
+    // Parse outside the lock; a racing miss on the same source just parses twice
+    ParsedProgram parsed;
+    if (!compileUserProgram(source, parsed, error)) return nullptr;
+    if (optimize) optimizeProgram(parsed.instructions, 0); // shared across memory sizes
+    auto program = std::make_shared<const Program>(assembleProgram(parsed.instructions));
+
+    std::lock_guard<std::mutex> lock(mtx);
+    if (capacity == 0 || index.count(source)) return program;
+    lru.push_front(Entry{std::string(source), program});
+    index.emplace(lru.front().source, lru.begin());
+    if (lru.size() > capacity) {
+        index.erase(lru.back().source);
+        lru.pop_back();
+        stats.evictions++;
+    }
+    return program;
+}
+
+ProgramCache::Stats ProgramCache::getStats() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    Stats current = stats;
+    current.entries = lru.size();
+    current.capacity = capacity;
+    return current;
+}
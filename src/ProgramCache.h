@@ -0,0 +1,44 @@
+#pragma once
+#include "Program.h"
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// Compiled screen -c programs keyed by their source text. Submitting the same
+// program under another name shares the cached image instead of parsing it
+// again; the least recently used entry is evicted once the cache is full.
+class ProgramCache {
+public:
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        size_t entries = 0;
+        size_t capacity = 0;
+    };
+
+    // 0 disables caching; clears entries and counters. With optimize set,
+    // images go through optimizeProgram before they are shared.
+    void reset(size_t capacity, bool optimize = false);
+
+    // Image for source under the screen -c rules, or null with error set
+    ProgramPtr compile(std::string_view source, std::string& error);
+
+    Stats getStats() const;
+
+private:
+    struct Entry {
+        std::string source;
+        ProgramPtr program;
+    };
+
+    mutable std::mutex mtx;
+    size_t capacity = 0;
+    bool optimize = false;
+    std::list<Entry> lru; // most recently used first; nodes never move, so keys stay valid
+    std::unordered_map<std::string_view, std::list<Entry>::iterator> index; // views of Entry::source
+    Stats stats;
+};
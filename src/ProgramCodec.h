@@ -0,0 +1,85 @@
+#pragma once
+#include "BinaryIO.h"
+#include "Program.h"
+
+// Binary form of a Program, shared by checkpoints and compiled workloads:
+//
+//   varint names, names x str; varint strings, strings x str;
+//   varint ops, ops x {u8 code, u8 flags, u16 a, u16 b, u16 c}
+inline void encodeProgram(BinaryWriter& out, const Program& program) {
+    out.varint(program.names.size());
+    for (const auto& name : program.names) out.str(name);
+    out.varint(program.strings.size());
+    for (const auto& text : program.strings) out.str(text);
+    out.varint(program.ops.size());
+    for (const Op& op : program.ops) {
+        out.u8(static_cast<uint8_t>(op.code));
+        out.u8(op.flags);
+        out.u16(op.a);
+        out.u16(op.b);
+        out.u16(op.c);
+    }
+}
+
+// Rejects ops whose slots, strings or loop targets fall outside the program
+inline bool decodeProgram(BinaryReader& in, Program& program) {
+    uint64_t names = in.varint();
+    program.names.clear();
+    for (uint64_t i = 0; i < names && !in.failed(); ++i) program.names.emplace_back(in.str());
+    uint64_t strings = in.varint();
+    program.strings.clear();
+    for (uint64_t i = 0; i < strings && !in.failed(); ++i) program.strings.emplace_back(in.str());
+
+    uint64_t count = in.varint();
+    const uint8_t* bytes = count <= UINT32_MAX ? in.take(count * sizeof(Op)) : nullptr;
+    if (!bytes || in.failed() || program.names.size() > 65536) return false;
+    program.ops.resize(static_cast<size_t>(count));
+    for (Op& op : program.ops) {
+        op.code = static_cast<OpCode>(bytes[0]);
+        op.flags = bytes[1];
+        op.a = static_cast<uint16_t>(bytes[2] | bytes[3] << 8);
+        op.b = static_cast<uint16_t>(bytes[4] | bytes[5] << 8);
+        op.c = static_cast<uint16_t>(bytes[6] | bytes[7] << 8);
+        bytes += sizeof(Op);
+    }
+
+    auto isSlot = [&](const Op& op, uint16_t field, uint8_t literal) {
+        return (op.flags & literal) || field < program.names.size();
+    };
+    for (const Op& op : program.ops) {
+        bool valid = true;
+        switch (op.code) {
+            case OpCode::PRINT:
+                valid = ((op.flags & Op::UnknownA) || isSlot(op, op.a, Op::LiteralA)) && op.wide() < program.strings.size();
+                break;
+            case OpCode::DECLARE:
+            case OpCode::SET:
+            case OpCode::READ:
+                valid = op.a < program.names.size();
+                break;
+            case OpCode::ADD:
+            case OpCode::SUBTRACT:
+                valid = op.a < program.names.size() && isSlot(op, op.b, Op::LiteralB) && isSlot(op, op.c, Op::LiteralC);
+                break;
+            case OpCode::WRITE:
+                valid = isSlot(op, op.a, Op::LiteralA);
+                break;
+            case OpCode::FOR_END:
+                valid = !(op.flags & Op::HasTarget) ||
+                        (op.wide() < count && program.ops[op.wide()].code == OpCode::FOR_START);
+                break;
+            case OpCode::FAULT:
+                valid = op.wide() < program.strings.size();
+                break;
+            case OpCode::SLEEP:
+            case OpCode::FOR_START:
+            case OpCode::NOP:
+                break;
+            default:
+                valid = false;
+                break;
+        }
+        if (!valid) return false;
+    }
+    return true;
+}
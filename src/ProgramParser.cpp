@@ -0,0 +1,305 @@
+#include "ProgramParser.h"
+#include <cctype>
+#include <charconv>
+
+namespace {
+
+enum class TokenKind { End, Word, String, LParen, RParen, LBracket, RBracket, Comma, Semicolon, Plus, Invalid };
+
+struct Token {
+    TokenKind kind = TokenKind::End;
+    std::string_view text; // word, or string contents without quotes
+    size_t offset = 0;
+};
+
+bool isWordChar(char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+bool isKeyword(std::string_view word, std::string_view keyword) {
+    if (word.size() != keyword.size()) return false;
+    for (size_t i = 0; i < word.size(); ++i) {
+        if (std::toupper(static_cast<unsigned char>(word[i])) != keyword[i]) return false;
+    }
+    return true;
+}
+
+bool isIdentifier(std::string_view word) {
+    return !word.empty() && !std::isdigit(static_cast<unsigned char>(word[0]));
+}
+
+// Decimal literal that fits the interpreter's uint16 values
+bool isNumber(std::string_view word) {
+    if (word.empty() || word.size() > 5) return false;
+    unsigned value = 0;
+    for (char c : word) {
+        if (!std::isdigit(static_cast<unsigned char>(c))) return false;
+        value = value * 10 + static_cast<unsigned>(c - '0');
+    }
+    return value <= 65535;
+}
+
+int toNumber(std::string_view word) {
+    int value = 0;
+    std::from_chars(word.data(), word.data() + word.size(), value);
+    return value;
+}
+
+// Hex address, with or without a 0x prefix
+bool isAddress(std::string_view word) {
+    if (word.size() > 2 && word[0] == '0' && (word[1] == 'x' || word[1] == 'X')) word.remove_prefix(2);
+    if (word.empty() || word.size() > 8) return false;
+    for (char c : word) {
+        if (!std::isxdigit(static_cast<unsigned char>(c))) return false;
+    }
+    return true;
+}
+
+// Value of an address accepted by isAddress, or -1 past the int range
+int toAddress(std::string_view word) {
+    if (word.size() > 2 && word[0] == '0' && (word[1] == 'x' || word[1] == 'X')) word.remove_prefix(2);
+    uint32_t value = 0;
+    std::from_chars(word.data(), word.data() + word.size(), value, 16);
+    return value <= 0x7fffffffu ? static_cast<int>(value) : -1;
+}
+
+class Parser {
+public:
+    Parser(std::string_view source, ParsedProgram& out, ParseError& error)
+        : src(source), out(out), error(error) {}
+
+    bool run() {
+        out.instructions.clear();
+        out.instructions.reserve(src.size() / 12); // roughly one statement per 12 bytes
+        out.statements = 0;
+        advance();
+        if (!parseSequence(0)) return false;
+        if (current.kind == TokenKind::RBracket) return fail("unexpected ']'");
+        return true;
+    }
+
+private:
+    void advance() {
+        while (pos < src.size() && std::isspace(static_cast<unsigned char>(src[pos]))) pos++;
+        current = Token{};
+        current.offset = pos;
+        if (pos >= src.size()) return;
+
+        char c = src[pos];
+        if (c == '"' || (c == '\\' && pos + 1 < src.size() && src[pos + 1] == '"')) {
+            size_t begin = pos + (c == '"' ? 1 : 2);
+            size_t close = src.find('"', begin);
+            if (close == std::string_view::npos) {
+                current.kind = TokenKind::Invalid;
+                current.text = "unterminated string";
+                return;
+            }
+            size_t end = close > begin && src[close - 1] == '\\' ? close - 1 : close;
+            current.kind = TokenKind::String;
+            current.text = src.substr(begin, end - begin);
+            pos = close + 1;
+            return;
+        }
+        if (isWordChar(c)) {
+            size_t begin = pos;
+            while (pos < src.size() && isWordChar(src[pos])) pos++;
+            current.kind = TokenKind::Word;
+            current.text = src.substr(begin, pos - begin);
+            return;
+        }
+
+        pos++;
+        switch (c) {
+            case '(': current.kind = TokenKind::LParen; break;
+            case ')': current.kind = TokenKind::RParen; break;
+            case '[': current.kind = TokenKind::LBracket; break;
+            case ']': current.kind = TokenKind::RBracket; break;
+            case ',': current.kind = TokenKind::Comma; break;
+            case ';': current.kind = TokenKind::Semicolon; break;
+            case '+': current.kind = TokenKind::Plus; break;
+            default:
+                current.kind = TokenKind::Invalid;
+                current.text = src.substr(pos - 1, 1);
+                break;
+        }
+    }
+
+    bool fail(const std::string& message) { return failAt(current, message); }
+
+    bool failAt(const Token& token, const std::string& message) {
+        error.column = token.offset + 1;
+        if (token.kind == TokenKind::Invalid) {
+            error.message = token.text == "unterminated string"
+                                ? std::string(token.text)
+                                : "unexpected character '" + std::string(token.text) + "'";
+        } else if (token.kind == TokenKind::End) {
+            error.message = message + " at end of program";
+        } else {
+            error.message = message;
+        }
+        return false;
+    }
+
+    bool expect(TokenKind kind, const char* what) {
+        if (current.kind != kind) return fail(std::string("expected ") + what);
+        advance();
+        return true;
+    }
+
+    // Consumes a word accepted by check and appends it to params
+    bool word(bool (*check)(std::string_view), const char* what, Instruction& instr) {
+        if (current.kind != TokenKind::Word || !check(current.text)) return fail(std::string("expected ") + what);
+        if (instr.params.empty()) instr.params.reserve(3); // one allocation per instruction
+        instr.params.emplace_back(current.text);
+        advance();
+        return true;
+    }
+
+    static bool isOperand(std::string_view text) { return isIdentifier(text) || isNumber(text); }
+
+    bool parseSequence(int depth) {
+        while (true) {
+            while (current.kind == TokenKind::Semicolon) advance();
+            if (current.kind == TokenKind::End || current.kind == TokenKind::RBracket) return true;
+            if (!parseStatement(depth)) return false;
+            if (current.kind == TokenKind::Semicolon) continue;
+            if (current.kind == TokenKind::End || current.kind == TokenKind::RBracket) return true;
+            return fail("expected ';' between statements");
+        }
+    }
+
+    bool parseStatement(int depth) {
+        if (current.kind != TokenKind::Word) return fail("expected an instruction");
+        std::string_view keyword = current.text;
+        Token start = current;
+        advance();
+        out.statements++;
+
+        if (isKeyword(keyword, "FOR")) return parseFor(depth, start);
+
+        Instruction instr;
+        bool ok;
+        if (isKeyword(keyword, "DECLARE")) {
+            instr.type = InstructionType::DECLARE;
+            ok = word(isIdentifier, "a variable name", instr) && word(isNumber, "a number (0-65535)", instr);
+            if (ok) instr.constant = toNumber(instr.params[1]);
+        } else if (isKeyword(keyword, "ADD") || isKeyword(keyword, "SUBTRACT")) {
+            instr.type = isKeyword(keyword, "ADD") ? InstructionType::ADD : InstructionType::SUBTRACT;
+            ok = word(isIdentifier, "a variable name", instr) && word(isOperand, "a variable or number", instr) &&
+                 word(isOperand, "a variable or number", instr);
+        } else if (isKeyword(keyword, "READ")) {
+            instr.type = InstructionType::READ;
+            ok = word(isIdentifier, "a variable name", instr) && word(isAddress, "a hex address", instr);
+            if (ok) instr.memoryAddress = toAddress(instr.params[1]);
+        } else if (isKeyword(keyword, "WRITE")) {
+            instr.type = InstructionType::WRITE;
+            ok = word(isAddress, "a hex address", instr) && word(isOperand, "a variable or number", instr);
+            if (ok) {
+                instr.memoryAddress = toAddress(instr.params[0]);
+                if (isNumber(instr.params[1])) instr.constant = toNumber(instr.params[1]);
+            }
+        } else if (isKeyword(keyword, "SLEEP")) {
+            instr.type = InstructionType::SLEEP;
+            ok = current.kind == TokenKind::Word && isNumber(current.text);
+            if (!ok) return fail("expected a cycle count");
+            instr.sleepCycles = toNumber(current.text);
+            advance();
+        } else if (isKeyword(keyword, "PRINT")) {
+            instr.type = InstructionType::PRINT;
+            ok = parsePrint(instr);
+        } else {
+            return failAt(start, "unknown instruction '" + std::string(keyword) + "'");
+        }
+        if (!ok) return false;
+        out.instructions.push_back(std::move(instr));
+        return true;
+    }
+
+    // Rebuilt in the canonical form the interpreter evaluates: "text", "text" + operand, or operand
+    bool parsePrint(Instruction& instr) {
+        if (!expect(TokenKind::LParen, "'(' after PRINT")) return false;
+        std::string message;
+        if (current.kind == TokenKind::String) {
+            message.reserve(current.text.size() + 2);
+            message += '"';
+            for (char c : current.text) {
+                if (c != '\\') message += c;
+            }
+            message += '"';
+            advance();
+            instr.constant = 0; // a message alone prints no value
+            if (current.kind == TokenKind::Plus) {
+                advance();
+                if (current.kind != TokenKind::Word || !isOperand(current.text)) {
+                    return fail("expected a variable or number after '+'");
+                }
+                message += " + ";
+                message += current.text;
+                instr.constant = isNumber(current.text) ? toNumber(current.text) : -1;
+                advance();
+            }
+        } else if (current.kind == TokenKind::Word && isOperand(current.text)) {
+            message = current.text;
+            if (isNumber(current.text)) instr.constant = toNumber(current.text);
+            advance();
+        } else {
+            return fail("expected a string or variable to print");
+        }
+        instr.params.push_back(std::move(message));
+        return expect(TokenKind::RParen, "')' to close PRINT");
+    }
+
+    bool parseFor(int depth, const Token& start) {
+        if (depth >= maxForDepth) {
+            return failAt(start, "FOR blocks nest at most " + std::to_string(maxForDepth) + " deep");
+        }
+        if (!expect(TokenKind::LParen, "'(' after FOR") || !expect(TokenKind::LBracket, "'[' to open the FOR body")) {
+            return false;
+        }
+
+        size_t head = out.instructions.size();
+        out.instructions.emplace_back(InstructionType::FOR_START);
+        if (!parseSequence(depth + 1)) return false;
+        if (!expect(TokenKind::RBracket, "']' to close the FOR body") || !expect(TokenKind::Comma, "',' before the repeat count")) {
+            return false;
+        }
+        if (current.kind != TokenKind::Word || !isNumber(current.text) || toNumber(current.text) == 0) {
+            return fail("expected a repeat count (1-65535)");
+        }
+        int repeats = toNumber(current.text);
+        advance();
+        if (!expect(TokenKind::RParen, "')' to close FOR")) return false;
+
+        Instruction tail(InstructionType::FOR_END);
+        tail.jumpTarget = static_cast<int>(head);
+        out.instructions[head].forRepeats = repeats;
+        out.instructions[head].jumpTarget = static_cast<int>(out.instructions.size());
+        out.instructions.push_back(std::move(tail));
+        return true;
+    }
+
+    std::string_view src;
+    size_t pos = 0;
+    Token current;
+    ParsedProgram& out;
+    ParseError& error;
+};
+
+} // namespace
+
+bool parseProgram(std::string_view source, ParsedProgram& out, ParseError& error) {
+    return Parser(source, out, error).run();
+}
+
+bool compileUserProgram(std::string_view source, ParsedProgram& out, std::string& error) {
+    ParseError parseError;
+    if (!parseProgram(source, out, parseError)) {
+        error = parseError.message + " (column " + std::to_string(parseError.column) + ")";
+        return false;
+    }
+    if (out.statements < 1 || out.statements > maxUserStatements) {
+        error = "must contain 1-" + std::to_string(maxUserStatements) + " instructions; got " + std::to_string(out.statements);
+        return false;
+    }
+    return true;
+}
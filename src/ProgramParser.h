@@ -0,0 +1,40 @@
+#pragma once
+#include "Instruction.h"
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Parser for the screen -c program language: a single pass over the source
+// with no intermediate copies, so only operands that end up in instructions
+// are allocated.
+//
+//   program   := [statement] (';' [statement])*
+//   statement := DECLARE var number
+//              | ADD var operand operand | SUBTRACT var operand operand
+//              | READ var address | WRITE address operand
+//              | SLEEP number
+//              | PRINT '(' (string ['+' operand] | operand) ')'
+//              | FOR '(' '[' program ']' ',' number ')'
+//
+// Keywords are case-insensitive, and strings may be quoted with \" as they are
+// inside a screen -c command. A FOR block becomes FOR_START, body, FOR_END,
+// with each marker's jumpTarget holding the index of the other. Addresses and
+// literal values are decoded into memoryAddress and constant up front.
+
+constexpr int maxForDepth = 3;          // the interpreter's loop stack
+constexpr int maxUserStatements = 50;   // screen -c limit
+
+struct ParseError {
+    size_t column = 0; // 1-based offset into the source
+    std::string message;
+};
+
+struct ParsedProgram {
+    std::vector<Instruction> instructions;
+    int statements = 0; // a FOR block and each statement inside it count once
+};
+
+bool parseProgram(std::string_view source, ParsedProgram& out, ParseError& error);
+
+// parseProgram plus the screen -c statement limit; the error names the column
+bool compileUserProgram(std::string_view source, ParsedProgram& out, std::string& error);
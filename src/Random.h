@@ -0,0 +1,65 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <limits>
+
+// xoshiro256** (Blackman & Vigna): small, fast and seedable. The state is
+// expanded from a single 64-bit seed with splitmix64, so nearby seeds (e.g.
+// consecutive pids) still give unrelated streams.
+class Xoshiro256 {
+public:
+    using result_type = uint64_t;
+
+    explicit Xoshiro256(uint64_t seed = 0) { reseed(seed); }
+
+    void reseed(uint64_t seed) {
+        for (auto& word : state) {
+            word = splitmix64(seed);
+        }
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()() {
+        const uint64_t result = rotl(state[1] * 5, 7) * 9;
+        const uint64_t t = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 45);
+        return result;
+    }
+
+    // Uniform in [0, 1)
+    double uniform01() { return static_cast<double>((*this)() >> 11) * 0x1.0p-53; }
+
+    // Uniform in [lo, hi]; modulo bias is negligible for the ranges we draw
+    uint64_t range(uint64_t lo, uint64_t hi) { return lo + (*this)() % (hi - lo + 1); }
+
+    // Raw state, for checkpoints
+    std::array<uint64_t, 4> getState() const { return {state[0], state[1], state[2], state[3]}; }
+    void setState(const std::array<uint64_t, 4>& words) {
+        for (size_t i = 0; i < words.size(); ++i) state[i] = words[i];
+    }
+
+    static uint64_t splitmix64(uint64_t& x) {
+        uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    // Independent stream for one item (e.g. a process) of a seeded run
+    static Xoshiro256 forStream(uint64_t seed, uint64_t stream) {
+        uint64_t mixed = seed ^ (stream * 0xD1B54A32D192ED03ull);
+        return Xoshiro256(splitmix64(mixed));
+    }
+
+private:
+    static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+    uint64_t state[4];
+};
@@ -0,0 +1,188 @@
+#include "RunTrace.h"
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <sstream>
+
+namespace {
+
+const char* typeName(RunEventType type) {
+    switch (type) {
+        case RunEventType::Arrival:  return "ARRIVAL";
+        case RunEventType::Dispatch: return "DISPATCH";
+        case RunEventType::Preempt:  return "PREEMPT";
+        case RunEventType::Finish:   return "FINISH";
+        case RunEventType::PageIn:   return "PAGEIN";
+        case RunEventType::PageOut:  return "PAGEOUT";
+    }
+    return "?";
+}
+
+constexpr size_t flushThreshold = 64 * 1024;
+
+} // namespace
+
+bool RunEvent::operator==(const RunEvent& other) const {
+    return type == other.type && tick == other.tick && core == other.core && pid == other.pid &&
+           a == other.a && b == other.b && name == other.name && source == other.source;
+}
+
+std::string RunEvent::describe() const {
+    std::stringstream ss;
+    ss << typeName(type) << " tick=" << tick << " core=" << core << " pid=" << pid
+       << " a=" << a << " b=" << b;
+    if (!name.empty()) ss << " name=" << name;
+    return ss.str();
+}
+
+RunRecorder::~RunRecorder() {
+    stop();
+}
+
+bool RunRecorder::start(const std::string& filename, const RunHeader& header) {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (active) return false;
+
+    out.open(filename, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) return false;
+
+    pending.clear();
+    pending.u32(magic);
+    pending.u32(version);
+    pending.u64(header.seed);
+    pending.varint(header.numCpu);
+    pending.str(header.scheduler);
+    pending.varint(header.quantumCycles);
+    pending.varint(header.delaysPerExec);
+    pending.varint(header.maxOverallMem);
+    pending.varint(header.memPerFrame);
+
+    lastTick = 0;
+    count = 0;
+    active = true;
+    return true;
+}
+
+size_t RunRecorder::stop() {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (!active) return 0;
+    active = false;
+    flushLocked();
+    out.close();
+    return count;
+}
+
+void RunRecorder::record(const RunEvent& event) {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (!active) return;
+
+    pending.u8(static_cast<uint8_t>(event.type));
+    // Signed delta: with several host workers, stamps can arrive slightly out of order
+    pending.svarint(static_cast<int64_t>(event.tick - lastTick));
+    pending.svarint(event.core);
+    pending.svarint(event.pid);
+    pending.svarint(event.a);
+    pending.svarint(event.b);
+    if (event.type == RunEventType::Arrival) {
+        pending.str(event.name);
+        pending.str(event.source);
+    }
+    lastTick = event.tick;
+    count++;
+
+    if (pending.size() >= flushThreshold) {
+        flushLocked();
+    }
+}
+
+void RunRecorder::flushLocked() {
+    pending.appendTo(out);
+    pending.clear();
+}
+
+bool RunReplayer::load(const std::string& filename) {
+    std::ifstream in(filename, std::ios::binary);
+    if (!in.is_open()) {
+        std::cout << "Error: Could not open trace " << filename << std::endl;
+        return false;
+    }
+    std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    BinaryReader reader(bytes.data(), bytes.size());
+    if (reader.u32() != RunRecorder::magic || reader.u32() != RunRecorder::version) {
+        std::cout << "Error: " << filename << " is not a run trace (or is from another version)." << std::endl;
+        return false;
+    }
+
+    header.seed = reader.u64();
+    header.numCpu = static_cast<int>(reader.varint());
+    header.scheduler = std::string(reader.str());
+    header.quantumCycles = reader.varint();
+    header.delaysPerExec = reader.varint();
+    header.maxOverallMem = reader.varint();
+    header.memPerFrame = reader.varint();
+
+    events.clear();
+    arrivals.clear();
+    uint64_t tick = 0;
+    while (!reader.atEnd() && !reader.failed()) {
+        RunEvent event;
+        event.type = static_cast<RunEventType>(reader.u8());
+        tick += static_cast<uint64_t>(reader.svarint());
+        event.tick = tick;
+        event.core = static_cast<int>(reader.svarint());
+        event.pid = static_cast<int>(reader.svarint());
+        event.a = reader.svarint();
+        event.b = reader.svarint();
+        if (event.type == RunEventType::Arrival) {
+            event.name = std::string(reader.str());
+            event.source = std::string(reader.str());
+            arrivals.push_back(events.size());
+        }
+        events.push_back(std::move(event));
+    }
+
+    if (reader.failed()) {
+        std::cout << "Error: " << filename << " is truncated." << std::endl;
+        return false;
+    }
+
+    nextArrival = 0;
+    nextCheck = 0;
+    diverged = false;
+    divergence.clear();
+    return true;
+}
+
+bool RunReplayer::nextArrivalDue(uint64_t now, RunEvent& out) {
+    if (nextArrival >= arrivals.size()) return false;
+    const RunEvent& event = events[arrivals[nextArrival]];
+    if (event.tick > now) return false;
+    out = event;
+    nextArrival++;
+    return true;
+}
+
+uint64_t RunReplayer::nextArrivalTick() const {
+    if (nextArrival >= arrivals.size()) return std::numeric_limits<uint64_t>::max();
+    return events[arrivals[nextArrival]].tick;
+}
+
+void RunReplayer::check(const RunEvent& live) {
+    if (isComplete()) return;
+
+    const RunEvent& expected = events[nextCheck];
+    if (!(live == expected)) {
+        diverged = true;
+        divergence = "event #" + std::to_string(nextCheck) + ": expected " + expected.describe() +
+                     ", got " + live.describe();
+        return;
+    }
+    nextCheck++;
+}
+
+void RunReplayer::fail(const std::string& reason) {
+    if (isComplete()) return;
+    diverged = true;
+    divergence = "event #" + std::to_string(nextCheck) + ": " + reason;
+}
@@ -0,0 +1,99 @@
+#pragma once
+#include "BinaryIO.h"
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+enum class RunEventType : uint8_t {
+    Arrival = 1, // pid, name; a = memory size, b = instruction count; source for screen -c
+    Dispatch,    // core, pid
+    Preempt,     // core, pid
+    Finish,      // core, pid; a = ExitReason
+    PageIn,      // pid; a = virtual page, b = frame
+    PageOut,     // pid of the victim; a = virtual page, b = frame
+};
+
+// One scheduling decision or memory event of a run, stamped with the CPU tick
+struct RunEvent {
+    RunEventType type = RunEventType::Arrival;
+    uint64_t tick = 0;
+    int core = -1;
+    int pid = -1;
+    int64_t a = 0;
+    int64_t b = 0;
+    std::string name;   // Arrival only
+    std::string source; // Arrival only: screen -c instruction text, empty if generated
+
+    bool operator==(const RunEvent& other) const;
+    std::string describe() const;
+};
+
+// Settings a replay must share with the recorded run to reproduce it
+struct RunHeader {
+    uint64_t seed = 0;
+    int numCpu = 0;
+    std::string scheduler;
+    uint64_t quantumCycles = 0;
+    uint64_t delaysPerExec = 0;
+    uint64_t maxOverallMem = 0;
+    uint64_t memPerFrame = 0;
+};
+
+// Appends run events to a compact binary trace: a header, then one record per
+// event with the tick delta and fields as zigzag varints
+class RunRecorder {
+public:
+    static constexpr uint32_t magic = 0x52545343; // "CSTR"
+    static constexpr uint32_t version = 1;
+
+    ~RunRecorder();
+
+    bool start(const std::string& filename, const RunHeader& header);
+    size_t stop(); // returns the number of events written
+    bool isActive() const { return active; }
+
+    void record(const RunEvent& event);
+
+private:
+    void flushLocked();
+
+    std::mutex mtx;
+    std::ofstream out;
+    BinaryWriter pending;
+    uint64_t lastTick = 0;
+    size_t count = 0;
+    std::atomic<bool> active{false};
+};
+
+// Loads a recorded trace, feeds its arrivals back at their original ticks and
+// checks every live event against the recording
+class RunReplayer {
+public:
+    bool load(const std::string& filename);
+    const RunHeader& getHeader() const { return header; }
+
+    // Recorded arrivals whose tick has come, in recorded order
+    bool nextArrivalDue(uint64_t now, RunEvent& out);
+    uint64_t nextArrivalTick() const;
+
+    void check(const RunEvent& live);
+    void fail(const std::string& reason);
+
+    bool isComplete() const { return diverged || nextCheck >= events.size(); }
+    bool hasDiverged() const { return diverged; }
+    size_t matched() const { return nextCheck; }
+    size_t total() const { return events.size(); }
+    const std::string& getDivergence() const { return divergence; }
+
+private:
+    RunHeader header;
+    std::vector<RunEvent> events;
+    std::vector<size_t> arrivals; // indices into events
+    size_t nextArrival = 0;
+    size_t nextCheck = 0;
+    bool diverged = false;
+    std::string divergence;
+};
@@ -0,0 +1,67 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+
+// Simulated CPU clock shared by the core pool and everything that paces itself
+// in CPU ticks. Ticks are advanced by the workers; other threads block on the
+// clock instead of spinning on it.
+class SimClock {
+public:
+    uint64_t now() const { return ticks.load(); }
+
+    void advance(uint64_t n) {
+        uint64_t current = ticks.fetch_add(n) + n;
+        // Only take the lock when a waiter's target has actually been reached
+        if (current >= nextWake.load()) {
+            std::lock_guard<std::mutex> lock(mtx);
+            nextWake = std::numeric_limits<uint64_t>::max();
+            cv.notify_all();
+        }
+    }
+
+    // Blocks until the clock reaches target. Returns false if interrupted or if
+    // the optional active flag was cleared (callers clear it, then wakeAll()).
+    bool waitUntil(uint64_t target, const std::atomic<bool>* active = nullptr) {
+        std::unique_lock<std::mutex> lock(mtx);
+        while (!interrupted && (!active || *active)) {
+            uint64_t wake = nextWake.load();
+            while (target < wake && !nextWake.compare_exchange_weak(wake, target)) {}
+            // Re-check after publishing the target so an advance can't slip between
+            if (ticks.load() >= target) return true;
+            cv.wait(lock);
+        }
+        return false;
+    }
+
+    bool waitFor(uint64_t delta, const std::atomic<bool>* active = nullptr) {
+        return waitUntil(now() + delta, active);
+    }
+
+    void wakeAll() {
+        std::lock_guard<std::mutex> lock(mtx);
+        cv.notify_all();
+    }
+
+    void interrupt() {
+        std::lock_guard<std::mutex> lock(mtx);
+        interrupted = true;
+        cv.notify_all();
+    }
+
+    void reset() {
+        std::lock_guard<std::mutex> lock(mtx);
+        ticks = 0;
+        nextWake = std::numeric_limits<uint64_t>::max();
+        interrupted = false;
+    }
+
+private:
+    std::atomic<uint64_t> ticks{0};
+    std::atomic<uint64_t> nextWake{std::numeric_limits<uint64_t>::max()};
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool interrupted = false;
+};
@@ -0,0 +1,67 @@
+#include "SparseMemory.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+alignas(64) uint8_t SparseMemory::zeroPage[SparseMemory::pageSize] = {};
+
+namespace {
+std::atomic<size_t> reservedTotal{0};
+std::atomic<size_t> residentTotal{0};
+}
+
+SparseMemory::Stats SparseMemory::getStats() {
+    // Read without a lock, so a process going away between the loads could
+    // leave resident momentarily above reserved
+    Stats stats;
+    stats.reserved = reservedTotal.load(std::memory_order_relaxed);
+    stats.resident = std::min(residentTotal.load(std::memory_order_relaxed), stats.reserved);
+    return stats;
+}
+
+SparseMemory::SparseMemory(size_t size, std::pmr::memory_resource* resource)
+    : resource(resource), pages((size + pageSize - 1) >> pageBits, zeroPage, resource), bytes(size) {
+    reservedTotal.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+SparseMemory::~SparseMemory() {
+    release();
+    reservedTotal.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+size_t SparseMemory::pageLength(size_t index) const {
+    return std::min<size_t>(pageSize, bytes - (index << pageBits));
+}
+
+void SparseMemory::materialize(size_t index) {
+    size_t length = pageLength(index);
+    pages[index] = static_cast<uint8_t*>(resource->allocate(length, 1));
+    std::memset(pages[index], 0, length);
+    resident += length;
+    residentTotal.fetch_add(length, std::memory_order_relaxed);
+}
+
+void SparseMemory::release() {
+    for (size_t index = 0; index < pages.size(); ++index) {
+        if (pages[index] != zeroPage) resource->deallocate(pages[index], pageLength(index), 1);
+        pages[index] = zeroPage;
+    }
+    residentTotal.fetch_sub(resident, std::memory_order_relaxed);
+    resident = 0;
+}
+
+void SparseMemory::assign(const uint8_t* data, size_t size) {
+    release();
+    reservedTotal.fetch_add(size, std::memory_order_relaxed);
+    reservedTotal.fetch_sub(bytes, std::memory_order_relaxed);
+    bytes = size;
+    pages.assign((size + pageSize - 1) >> pageBits, zeroPage);
+
+    for (size_t index = 0; index < pages.size(); ++index) {
+        const uint8_t* source = data + (index << pageBits);
+        size_t length = pageLength(index);
+        if (std::all_of(source, source + length, [](uint8_t b) { return b == 0; })) continue;
+        materialize(index);
+        std::memcpy(pages[index], source, length);
+    }
+}
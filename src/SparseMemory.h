@@ -0,0 +1,77 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+// A process's simulated address space, allocated a page at a time. Every page
+// starts out pointing at one shared zero page, so untouched memory reads as
+// zero and costs only its slot in the page table; a page gets its own bytes
+// the first time something is written to it.
+class SparseMemory {
+public:
+    static constexpr uint32_t pageBits = 8;
+    static constexpr uint32_t pageSize = 1u << pageBits;
+
+    // Totals over every live process
+    struct Stats {
+        size_t reserved = 0; // bytes processes were given
+        size_t resident = 0; // bytes held by materialized pages
+    };
+    static Stats getStats();
+
+    explicit SparseMemory(size_t size = 0, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    ~SparseMemory();
+    SparseMemory(const SparseMemory&) = delete;
+    SparseMemory& operator=(const SparseMemory&) = delete;
+
+    size_t size() const { return bytes; }
+    size_t pageCount() const { return pages.size(); }
+    size_t pageLength(size_t index) const;
+    const uint8_t* page(size_t index) const { return pages[index]; }
+    size_t residentBytes() const { return resident; }
+
+    // Little endian; both bytes must lie inside the memory
+    uint16_t read16(uint32_t address) const {
+        uint32_t offset = address & (pageSize - 1);
+        if (offset == pageSize - 1) {
+            return static_cast<uint16_t>(at(address) | at(address + 1) << 8);
+        }
+        const uint8_t* bytes = pages[address >> pageBits] + offset;
+        return static_cast<uint16_t>(bytes[0] | bytes[1] << 8);
+    }
+
+    void write16(uint32_t address, uint16_t value) {
+        uint32_t offset = address & (pageSize - 1);
+        if (offset == pageSize - 1) {
+            writable(address)[0] = static_cast<uint8_t>(value & 0xFF);
+            writable(address + 1)[0] = static_cast<uint8_t>(value >> 8);
+            return;
+        }
+        uint8_t* bytes = writable(address);
+        bytes[0] = static_cast<uint8_t>(value & 0xFF);
+        bytes[1] = static_cast<uint8_t>(value >> 8);
+    }
+
+    // Replaces the contents; pages that are all zero stay on the shared page
+    void assign(const uint8_t* data, size_t size);
+
+private:
+    uint8_t at(uint32_t address) const { return pages[address >> pageBits][address & (pageSize - 1)]; }
+
+    uint8_t* writable(uint32_t address) {
+        uint8_t*& page = pages[address >> pageBits];
+        if (page == zeroPage) materialize(address >> pageBits);
+        return page + (address & (pageSize - 1));
+    }
+
+    void materialize(size_t index);
+    void release();
+
+    static uint8_t zeroPage[pageSize]; // never written
+
+    std::pmr::memory_resource* resource; // page table and pages
+    std::pmr::vector<uint8_t*> pages;
+    size_t bytes = 0;
+    size_t resident = 0;
+};
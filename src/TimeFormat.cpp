@@ -0,0 +1,50 @@
+#include "TimeFormat.h"
+#include <ctime>
+
+namespace {
+
+constexpr int styleCount = 3;
+
+const char* pattern(TimeFormat::Style style) {
+    switch (style) {
+        case TimeFormat::Style::Clock: return "%H:%M:%S";
+        case TimeFormat::Style::Stamp: return "%Y-%m-%d %H:%M:%S";
+        case TimeFormat::Style::Full:
+        default: return "%m/%d/%Y, %I:%M:%S %p";
+    }
+}
+
+struct CachedSecond {
+    std::time_t second = -1;
+    std::string text;
+};
+
+// localtime() shares one static buffer between threads; use the reentrant form
+bool toLocalTime(std::time_t time, std::tm& out) {
+#ifdef _WIN32
+    return localtime_s(&out, &time) == 0;
+#else
+    return localtime_r(&time, &out) != nullptr;
+#endif
+}
+
+} // namespace
+
+std::string TimeFormat::format(TimePoint time, Style style) {
+    thread_local CachedSecond cache[styleCount];
+
+    std::time_t second = std::chrono::system_clock::to_time_t(time);
+    CachedSecond& cached = cache[static_cast<int>(style)];
+    if (cached.second == second) {
+        return cached.text;
+    }
+
+    std::tm local{};
+    char buffer[32] = {};
+    if (toLocalTime(second, local)) {
+        std::strftime(buffer, sizeof(buffer), pattern(style), &local);
+    }
+    cached.second = second;
+    cached.text = buffer;
+    return cached.text;
+}
@@ -0,0 +1,20 @@
+#pragma once
+#include <chrono>
+#include <string>
+
+// Wall-clock formatting for everything the console and logs print. Timestamps
+// are stored as time points and only turned into text here, through a
+// per-thread cache of the last second formatted in each style.
+class TimeFormat {
+public:
+    using TimePoint = std::chrono::system_clock::time_point;
+
+    enum class Style {
+        Full,   // 06/27/2025, 08:35:18 PM
+        Clock,  // 20:35:18
+        Stamp,  // 2025-06-27 20:35:18
+    };
+
+    static std::string format(TimePoint time, Style style = Style::Full);
+    static std::string now(Style style = Style::Full) { return format(std::chrono::system_clock::now(), style); }
+};
@@ -0,0 +1,163 @@
+#include "Tracer.h"
+#include "Json.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+namespace {
+
+std::atomic<uint64_t> nextTracerId{1};
+
+const char* eventName(TraceEventType type) {
+    switch (type) {
+        case TraceEventType::Dispatch:      return "dispatch";
+        case TraceEventType::QuantumExpiry: return "quantum-expiry";
+        case TraceEventType::Preempt:       return "preempt";
+        case TraceEventType::Finish:        return "finish";
+        case TraceEventType::PageFault:     return "page-fault";
+        case TraceEventType::Eviction:      return "eviction";
+        case TraceEventType::MemoryDump:    return "memory-dump";
+    }
+    return "?";
+}
+
+} // namespace
+
+Tracer::Tracer() : id(nextTracerId++) {}
+
+void Tracer::start(int cpuCount) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    numCpu = cpuCount;
+    for (auto& buffer : buffers) {
+        std::lock_guard<std::mutex> bufferLock(buffer->mtx);
+        buffer->events.clear();
+        buffer->dropped = 0;
+    }
+    processNames.clear();
+    enabled = true;
+}
+
+void Tracer::stop() {
+    enabled = false;
+}
+
+Tracer::ThreadBuffer* Tracer::localBuffer() {
+    thread_local uint64_t cachedId = 0;
+    thread_local ThreadBuffer* cached = nullptr;
+    if (cachedId == id) return cached;
+
+    // First event from this thread: buffers live as long as the tracer
+    std::lock_guard<std::mutex> lock(registryMutex);
+    buffers.push_back(std::make_unique<ThreadBuffer>());
+    buffers.back()->events.reserve(4096);
+    cachedId = id;
+    cached = buffers.back().get();
+    return cached;
+}
+
+void Tracer::record(TraceEventType type, uint64_t tick, int core, int pid, int32_t arg) {
+    if (!isEnabled()) return;
+
+    ThreadBuffer* buffer = localBuffer();
+    std::lock_guard<std::mutex> lock(buffer->mtx); // only contended while exporting
+    if (buffer->events.size() >= maxEventsPerThread) {
+        buffer->dropped++;
+        return;
+    }
+    buffer->events.push_back(TraceEvent{tick, pid, arg, static_cast<int16_t>(core), type});
+}
+
+void Tracer::nameProcess(int pid, const std::string& name) {
+    if (!isEnabled()) return;
+    std::lock_guard<std::mutex> lock(registryMutex);
+    processNames[pid] = name;
+}
+
+uint64_t Tracer::getDropped() const {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    uint64_t dropped = 0;
+    for (const auto& buffer : buffers) {
+        std::lock_guard<std::mutex> bufferLock(buffer->mtx);
+        dropped += buffer->dropped;
+    }
+    return dropped;
+}
+
+size_t Tracer::exportChromeTrace(const std::string& filename) const {
+    std::vector<TraceEvent> events;
+    std::unordered_map<int, std::string> names;
+    int cpuCount;
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        for (const auto& buffer : buffers) {
+            std::lock_guard<std::mutex> bufferLock(buffer->mtx);
+            events.insert(events.end(), buffer->events.begin(), buffer->events.end());
+        }
+        names = processNames;
+        cpuCount = numCpu;
+    }
+
+    // Stable, so each core keeps the order its worker recorded in
+    std::stable_sort(events.begin(), events.end(),
+        [](const TraceEvent& a, const TraceEvent& b) { return a.tick < b.tick; });
+
+    std::ofstream out(filename);
+    if (!out.is_open()) {
+        std::cout << "Error: Could not create " << filename << std::endl;
+        return 0;
+    }
+
+    // One timeline row per core plus one for memory events raised outside a core
+    const int memoryTid = cpuCount;
+    out << "{\"displayTimeUnit\":\"ns\",\"otherData\":{\"time-unit\":\"1 us = 1 CPU tick\"},\"traceEvents\":[\n";
+    out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":0,\"args\":{\"name\":\"csopesy\"}}";
+    for (int core = 0; core < cpuCount; ++core) {
+        out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << core
+            << ",\"args\":{\"name\":\"Core " << core << "\"}}";
+    }
+    out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << memoryTid
+        << ",\"args\":{\"name\":\"Memory\"}}";
+
+    auto processName = [&names](int pid) {
+        auto it = names.find(pid);
+        return it != names.end() ? it->second : "pid " + std::to_string(pid);
+    };
+
+    for (const TraceEvent& e : events) {
+        int tid = e.core >= 0 ? e.core : memoryTid;
+        out << ",\n";
+        switch (e.type) {
+            case TraceEventType::Dispatch:
+                out << "{\"name\":";
+                writeJsonString(out, processName(e.pid));
+                out << ",\"cat\":\"sched\",\"ph\":\"B\",\"ts\":" << e.tick << ",\"pid\":0,\"tid\":" << tid
+                    << ",\"args\":{\"pid\":" << e.pid << "}}";
+                break;
+            case TraceEventType::Preempt:
+            case TraceEventType::Finish:
+                // Close the running slice, then mark why it ended
+                out << "{\"ph\":\"E\",\"ts\":" << e.tick << ",\"pid\":0,\"tid\":" << tid << "},\n"
+                    << "{\"name\":\"" << eventName(e.type) << "\",\"cat\":\"sched\",\"ph\":\"i\",\"s\":\"t\",\"ts\":"
+                    << e.tick << ",\"pid\":0,\"tid\":" << tid << ",\"args\":{\"pid\":" << e.pid;
+                if (e.type == TraceEventType::Finish) out << ",\"exit\":" << e.arg;
+                out << "}}";
+                break;
+            case TraceEventType::QuantumExpiry:
+                out << "{\"name\":\"quantum-expiry\",\"cat\":\"sched\",\"ph\":\"i\",\"s\":\"t\",\"ts\":" << e.tick
+                    << ",\"pid\":0,\"tid\":" << tid << ",\"args\":{\"pid\":" << e.pid << "}}";
+                break;
+            case TraceEventType::PageFault:
+            case TraceEventType::Eviction:
+                out << "{\"name\":\"" << eventName(e.type) << "\",\"cat\":\"memory\",\"ph\":\"i\",\"s\":\"t\",\"ts\":"
+                    << e.tick << ",\"pid\":0,\"tid\":" << tid << ",\"args\":{\"pid\":" << e.pid
+                    << ",\"page\":" << e.arg << "}}";
+                break;
+            case TraceEventType::MemoryDump:
+                out << "{\"name\":\"memory-dump\",\"cat\":\"memory\",\"ph\":\"i\",\"s\":\"g\",\"ts\":" << e.tick
+                    << ",\"pid\":0,\"tid\":" << tid << ",\"args\":{\"dump\":" << e.arg << "}}";
+                break;
+        }
+    }
+    out << "\n]}\n";
+    return events.size();
+}
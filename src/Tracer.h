@@ -0,0 +1,67 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+enum class TraceEventType : uint8_t {
+    Dispatch,      // core, pid
+    QuantumExpiry, // core, pid
+    Preempt,       // core, pid
+    Finish,        // core, pid; arg = ExitReason
+    PageFault,     // pid; arg = virtual page
+    Eviction,      // pid of the victim; arg = virtual page
+    MemoryDump,    // arg = dump number
+};
+
+struct TraceEvent {
+    uint64_t tick;
+    int32_t pid;
+    int32_t arg;
+    int16_t core;
+    TraceEventType type;
+};
+
+// Optional timeline of core activity, exported as Chrome trace JSON (loads in
+// chrome://tracing or Perfetto). Each recording thread appends to its own
+// buffer, so cores never contend with each other; the buffers are only merged
+// on export. Costs one relaxed load per call site while disabled.
+class Tracer {
+public:
+    static constexpr size_t maxEventsPerThread = 1 << 20;
+
+    Tracer();
+
+    void start(int numCpu);
+    void stop();
+    bool isEnabled() const { return enabled.load(std::memory_order_relaxed); }
+
+    void record(TraceEventType type, uint64_t tick, int core, int pid, int32_t arg = 0);
+    // Names are looked up on export; recorded once per process, not per event
+    void nameProcess(int pid, const std::string& name);
+
+    // Returns the number of events written
+    size_t exportChromeTrace(const std::string& filename) const;
+    uint64_t getDropped() const;
+
+private:
+    struct ThreadBuffer {
+        std::mutex mtx;
+        std::vector<TraceEvent> events;
+        uint64_t dropped = 0;
+    };
+
+    ThreadBuffer* localBuffer();
+
+    const uint64_t id; // tells thread-local caches of different tracers apart
+    std::atomic<bool> enabled{false};
+    int numCpu = 0;
+
+    mutable std::mutex registryMutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    std::unordered_map<int, std::string> processNames;
+};
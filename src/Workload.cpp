@@ -0,0 +1,236 @@
+#include "Workload.h"
+#include "Optimizer.h"
+#include "ProcessPool.h"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+
+namespace {
+
+// prefix + decimal/hex number, built without streams or temporaries
+std::string withNumber(const char* prefix, uint64_t value, int base = 10) {
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value, base);
+    std::string text(prefix);
+    text.append(digits, result.ptr);
+    return text;
+}
+
+} // namespace
+
+WorkloadGenerator::~WorkloadGenerator() {
+    stop();
+}
+
+void WorkloadGenerator::configure(const Config& config, uint64_t newSeed) {
+    seed = newSeed;
+    minIns = config.getMinIns();
+    maxIns = config.getMaxIns();
+    minMem = static_cast<int>(config.getMinMemPerProc());
+    insDist = config.getInsDist();
+    memDist = config.getMemDist();
+    optimize = config.isOptimize();
+
+    {
+        // Staged processes carry pids from the previous run's counter
+        std::lock_guard<std::mutex> lock(stageMutex);
+        staged.clear();
+    }
+
+    memSizes.clear();
+    for (int p = 6; p <= 16; ++p) {
+        unsigned long val = 1ul << p;
+        if (val >= config.getMinMemPerProc() && val <= config.getMaxMemPerProc()) {
+            memSizes.push_back(static_cast<int>(val));
+        }
+    }
+}
+
+void WorkloadGenerator::start(int threadCount, std::atomic<uint64_t>& pidCounter) {
+    if (running) return;
+    running = true;
+    stageCapacity = static_cast<size_t>(threadCount) * 4;
+    for (int i = 0; i < threadCount; ++i) {
+        threads.emplace_back(&WorkloadGenerator::generatorLoop, this, &pidCounter);
+    }
+}
+
+void WorkloadGenerator::stop() {
+    {
+        std::lock_guard<std::mutex> lock(stageMutex);
+        running = false;
+    }
+    notFull.notify_all();
+    notEmpty.notify_all();
+    for (auto& thread : threads) {
+        if (thread.joinable()) thread.join();
+    }
+    threads.clear();
+    // Staged processes already own their pids and names; the next start()
+    // hands them out first instead of burning them
+}
+
+ProcessPtr WorkloadGenerator::take() {
+    std::unique_lock<std::mutex> lock(stageMutex);
+    // The front slot holds the lowest reserved pid, so processes leave in pid
+    // order even when a later one finishes building first
+    notEmpty.wait(lock, [this] { return !running || (!staged.empty() && staged.front().process); });
+    if (!running) return nullptr;
+
+    ProcessPtr process = std::move(staged.front().process);
+    staged.pop_front();
+    lock.unlock();
+    notFull.notify_one();
+    process->creationTime = std::chrono::system_clock::now(); // admitted, not built
+    return process;
+}
+
+void WorkloadGenerator::generatorLoop(std::atomic<uint64_t>* pidCounter) {
+    while (true) {
+        // Reserve the pid and its slot together, so slots stay in pid order
+        int pid;
+        {
+            std::unique_lock<std::mutex> lock(stageMutex);
+            notFull.wait(lock, [this] { return !running || staged.size() < stageCapacity; });
+            if (!running) return;
+            pid = static_cast<int>((*pidCounter)++);
+            staged.push_back(StagedProcess{pid, nullptr});
+        }
+
+        ProcessPtr process = build(withNumber("p", pid), pid);
+
+        {
+            std::lock_guard<std::mutex> lock(stageMutex);
+            auto slot = std::find_if(staged.begin(), staged.end(),
+                [pid](const StagedProcess& entry) { return entry.pid == pid; });
+            slot->process = std::move(process);
+        }
+        notEmpty.notify_one();
+    }
+}
+
+ProcessPtr WorkloadGenerator::build(const std::string& name, int pid, int memSize, int insCount) const {
+    // Always draw both so an override leaves the instruction stream unchanged
+    Xoshiro256 rng = Xoshiro256::forStream(seed, static_cast<uint64_t>(pid));
+    int drawnMem = pickMemorySize(rng);
+    int drawnIns = pickInstructionCount(rng);
+    if (memSize == -1) memSize = drawnMem;
+    if (insCount == -1) insCount = drawnIns;
+
+    auto process = ProcessPool::make(name, pid, memSize);
+    generateInstructions(*process, insCount, rng);
+    return process;
+}
+
+int WorkloadGenerator::pickMemorySize(Xoshiro256& rng) const {
+    if (memSizes.empty()) return minMem;
+    if (memDist == "geometric") {
+        // Each size up is half as likely as the one below it
+        size_t index = 0;
+        while (index + 1 < memSizes.size() && (rng() & 1)) index++;
+        return memSizes[index];
+    }
+    return memSizes[rng() % memSizes.size()];
+}
+
+int WorkloadGenerator::pickInstructionCount(Xoshiro256& rng) const {
+    const double lo = static_cast<double>(minIns);
+    const double hi = static_cast<double>(maxIns);
+    double count;
+
+    if (insDist == "normal") {
+        // Box-Muller, centred in the range with +/-3 sigma spanning it
+        constexpr double twoPi = 6.283185307179586;
+        double u1 = 1.0 - rng.uniform01();
+        double u2 = rng.uniform01();
+        double z = std::sqrt(-2.0 * std::log(u1)) * std::cos(twoPi * u2);
+        count = (lo + hi) / 2.0 + z * (hi - lo) / 6.0;
+    } else if (insDist == "exponential") {
+        // Mostly short programs with a long tail toward max-ins
+        count = lo - std::log(1.0 - rng.uniform01()) * (hi - lo) / 4.0;
+    } else {
+        return static_cast<int>(rng.range(minIns, maxIns));
+    }
+    return static_cast<int>(std::clamp(std::round(count), lo, hi));
+}
+
+void WorkloadGenerator::generateInstructions(Process& process, int count, Xoshiro256& rng) const {
+    const int memorySize = process.memorySize;
+    const std::string greeting = "\"Hello world from " + process.name + "!\"";
+    // A plain message carries no value, unless the name itself contains " + "
+    const int greetingValue = greeting.find(" + ") == std::string::npos ? 0 : -1;
+
+    // Reused by every build on this thread: the instructions and their params
+    // keep their capacity, so only the assembled program is allocated. Those
+    // beyond this build's count wait in spare rather than being destroyed.
+    thread_local std::vector<Instruction> program;
+    thread_local std::vector<Instruction> spare;
+    while (program.size() > static_cast<size_t>(count)) {
+        spare.push_back(std::move(program.back()));
+        program.pop_back();
+    }
+    while (program.size() < static_cast<size_t>(count) && !spare.empty()) {
+        program.push_back(std::move(spare.back()));
+        spare.pop_back();
+    }
+    program.resize(count);
+
+    for (int i = 0; i < count; i++) {
+        Instruction& instr = program[i];
+        int type = static_cast<int>(rng() % 9);
+        switch (type) {
+            case 0: // PRINT
+                instr.reset(InstructionType::PRINT, 1);
+                instr.params[0] = greeting;
+                instr.constant = greetingValue;
+                break;
+            case 1: // DECLARE
+                instr.reset(InstructionType::DECLARE, 2);
+                instr.params[0] = withNumber("var", i);
+                instr.constant = static_cast<int>(rng() % 100);
+                instr.params[1] = withNumber("", instr.constant);
+                break;
+            case 2: // ADD
+            case 3: // SUBTRACT
+                instr.reset(type == 2 ? InstructionType::ADD : InstructionType::SUBTRACT, 3);
+                instr.params[0] = withNumber("result", i);
+                instr.params[1] = "var1";
+                instr.params[2] = "var2";
+                break;
+            case 4: // SLEEP
+                instr.reset(InstructionType::SLEEP);
+                instr.sleepCycles = static_cast<int>(rng() % 10) + 1;
+                break;
+            case 5: // FOR_START
+                instr.reset(InstructionType::FOR_START);
+                instr.forRepeats = static_cast<int>(rng() % 5) + 1;
+                break;
+            case 6: // FOR_END
+                instr.reset(InstructionType::FOR_END);
+                break;
+            case 7: // READ
+                // Skip the address if memory is too small to hold one past the symbol table
+                instr.reset(InstructionType::READ, memorySize > 64 ? 2 : 1);
+                instr.params[0] = withNumber("readVar", i);
+                if (memorySize > 64) {
+                    instr.memoryAddress = 64 + static_cast<int>(rng() % (memorySize - 64));
+                    instr.params[1] = withNumber("0x", instr.memoryAddress, 16);
+                }
+                break;
+            case 8: // WRITE
+                if (memorySize <= 64) {
+                    instr.reset(InstructionType::WRITE);
+                    break;
+                }
+                instr.reset(InstructionType::WRITE, 2);
+                instr.memoryAddress = 64 + static_cast<int>(rng() % (memorySize - 64));
+                instr.constant = static_cast<int>(rng() % 256);
+                instr.params[0] = withNumber("0x", instr.memoryAddress, 16);
+                instr.params[1] = withNumber("", instr.constant);
+                break;
+        }
+    }
+    if (optimize) optimizeProgram(program, memorySize);
+    process.setProgram(process.adoptProgram(assembleProgram(program, &process.arena)));
+}
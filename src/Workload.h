@@ -0,0 +1,64 @@
+#pragma once
+#include "Config.h"
+#include "Process.h"
+#include "Random.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Builds the random processes used by batch generation and screen -s.
+// Every process draws from its own PRNG stream keyed by (seed, pid), so the
+// content of a process does not depend on which thread generated it.
+// While batch generation runs, helper threads keep a small staging buffer
+// filled so admission only has to allocate memory and enqueue. take() hands
+// processes out in pid order, and stop() keeps whatever is staged.
+class WorkloadGenerator {
+public:
+    ~WorkloadGenerator();
+
+    void configure(const Config& config, uint64_t seed);
+    void start(int threadCount, std::atomic<uint64_t>& pidCounter);
+    void stop();
+
+    // Next prepared batch process; blocks until one is ready, nullptr once stopped
+    ProcessPtr take();
+
+    // Builds one process on the calling thread. -1 draws the memory size or
+    // instruction count from the configured distribution.
+    ProcessPtr build(const std::string& name, int pid, int memSize = -1, int insCount = -1) const;
+
+    int pickMemorySize(Xoshiro256& rng) const;
+    int pickInstructionCount(Xoshiro256& rng) const;
+    void generateInstructions(Process& process, int count, Xoshiro256& rng) const;
+
+    uint64_t getSeed() const { return seed; }
+
+private:
+    void generatorLoop(std::atomic<uint64_t>* pidCounter);
+
+    uint64_t seed = 0;
+    unsigned long minIns = 1;
+    unsigned long maxIns = 1;
+    int minMem = 64;
+    std::vector<int> memSizes; // powers of two within [min-mem-per-proc, max-mem-per-proc]
+    std::string insDist = "uniform";
+    std::string memDist = "uniform";
+    bool optimize = false;
+
+    // Reserved in pid order; process stays null until its build finishes
+    struct StagedProcess {
+        int pid;
+        ProcessPtr process;
+    };
+    std::deque<StagedProcess> staged;
+    size_t stageCapacity = 0;
+    std::mutex stageMutex;
+    std::condition_variable notFull;
+    std::condition_variable notEmpty;
+    std::atomic<bool> running{false};
+    std::vector<std::thread> threads;
+};
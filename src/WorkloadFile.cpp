@@ -0,0 +1,80 @@
+#include "WorkloadFile.h"
+#include "ProgramCodec.h"
+#include "ProgramParser.h"
+#include <fstream>
+
+namespace workloadfile {
+
+bool validMemorySize(int memSize) {
+    return memSize >= minMemory && memSize <= maxMemory && (memSize & (memSize - 1)) == 0;
+}
+
+bool Writer::add(const std::string& name, int memSize, const std::string& source, std::string& error) {
+    if (name.empty()) {
+        error = "missing process name";
+        return false;
+    }
+    if (!validMemorySize(memSize)) {
+        error = "invalid memory allocation " + std::to_string(memSize);
+        return false;
+    }
+    ParsedProgram parsed;
+    if (!compileUserProgram(source, parsed, error)) return false;
+
+    body.str(name);
+    body.varint(static_cast<uint64_t>(memSize));
+    body.str(source);
+    encodeProgram(body, assembleProgram(parsed.instructions));
+    count++;
+    return true;
+}
+
+bool Writer::save(const std::string& filename) const {
+    BinaryWriter header;
+    header.u32(magic);
+    header.u32(version);
+    header.u32(count);
+    header.u32(0);
+
+    std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) return false;
+    header.appendTo(out);
+    body.appendTo(out);
+    return static_cast<bool>(out);
+}
+
+bool File::open(const std::string& filename, std::string& error) {
+    if (!file.open(filename)) {
+        error = "could not open " + filename;
+        return false;
+    }
+
+    in = BinaryReader(file.data(), file.size());
+    if (in.u32() != magic) {
+        error = filename + " is not a compiled workload";
+        return false;
+    }
+    uint32_t fileVersion = in.u32();
+    if (fileVersion != version) {
+        error = "unsupported workload version " + std::to_string(fileVersion);
+        return false;
+    }
+    count = in.u32();
+    in.u32();
+    if (in.failed()) {
+        error = filename + " is truncated";
+        return false;
+    }
+    return true;
+}
+
+bool File::next(ProgramHeader& header) {
+    header.name = in.str();
+    uint64_t memSize = in.varint();
+    header.source = in.str();
+    if (in.failed() || memSize > static_cast<uint64_t>(maxMemory)) return false;
+    header.memSize = static_cast<int>(memSize);
+    return true;
+}
+
+} // namespace workloadfile
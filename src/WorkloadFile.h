@@ -0,0 +1,63 @@
+#pragma once
+#include "BinaryIO.h"
+#include "Program.h"
+#include "MappedFile.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Compiled workload for `load-workload`, produced by csopesy-wlc from
+// screen -c style text. Programs are stored assembled, so loading is a
+// decode straight into each Process with no text parsing:
+//
+//   u32 magic "CSWL", u32 version, u32 programs, u32 reserved
+//   programs x {str name, varint mem-size, str source, program (ProgramCodec.h)}
+//
+// The source text is kept so recorded runs can replay loaded programs.
+namespace workloadfile {
+
+constexpr uint32_t magic = 0x4C575343; // "CSWL"
+constexpr uint32_t version = 4;
+
+constexpr int minMemory = 64;
+constexpr int maxMemory = 65536;
+
+bool validMemorySize(int memSize);
+
+class Writer {
+public:
+    // Parses and validates one program; false with error set if rejected
+    bool add(const std::string& name, int memSize, const std::string& source, std::string& error);
+    bool save(const std::string& filename) const;
+    uint32_t getCount() const { return count; }
+
+private:
+    BinaryWriter body;
+    uint32_t count = 0;
+};
+
+// One program header; its encoded program follows in the reader
+struct ProgramHeader {
+    std::string_view name;
+    int memSize = 0;
+    std::string_view source;
+};
+
+class File {
+public:
+    bool open(const std::string& filename, std::string& error);
+    uint32_t getCount() const { return count; }
+    size_t size() const { return file.size(); }
+
+    // Reads the next header; the caller then decodes the program from
+    // reader() before asking for the next one
+    bool next(ProgramHeader& header);
+    BinaryReader& reader() { return in; }
+
+private:
+    MappedFile file;
+    BinaryReader in;
+    uint32_t count = 0;
+};
+
+} // namespace workloadfile
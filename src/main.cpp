@@ -1,7 +1,28 @@
 #include "Console.h"
+#include <cstring>
+#include <fstream>
+#include <iostream>
 
-int main() {
+int main(int argc, char** argv) {
     Console console;
+
+    // csopesy --script <file|->: run commands headless instead of interactively
+    if (argc >= 2 && std::strcmp(argv[1], "--script") == 0) {
+        if (argc < 3) {
+            std::cerr << "Usage: " << argv[0] << " --script <file|->" << std::endl;
+            return 2;
+        }
+        if (std::strcmp(argv[2], "-") == 0) {
+            return console.runScript(std::cin);
+        }
+        std::ifstream script(argv[2]);
+        if (!script.is_open()) {
+            std::cerr << "Error: Could not open script " << argv[2] << std::endl;
+            return 2;
+        }
+        return console.runScript(script);
+    }
+
     console.run();
     return 0;
-}
\ No newline at end of file
+}
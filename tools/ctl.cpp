@@ -0,0 +1,214 @@
+// Command-line client for the control socket (`control-start` in the console).
+// Built with `make ctl`.
+//
+//   csopesy-ctl [-S <socket>] submit <name> [mem] ["<instructions>"]
+//   csopesy-ctl [-S <socket>] pid <pid>
+//   csopesy-ctl [-S <socket>] vmstat
+//   csopesy-ctl [-S <socket>] smi [-s <column>] [-n <count>]
+//   csopesy-ctl [-S <socket>] bench <count> [batch] [mem]
+//
+// Query commands print the server's JSON. bench submits <count> generated
+// processes, <batch> per frame, and prints the submission throughput as JSON.
+#include "../src/ControlProtocol.h"
+#include <iostream>
+
+#ifdef _WIN32
+
+int main() {
+    std::cerr << "csopesy-ctl: the control socket is not supported on Windows" << std::endl;
+    return 1;
+}
+
+#else
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+int connectTo(const std::string& path) {
+    sockaddr_un addr{};
+    if (path.size() >= sizeof(addr.sun_path)) return -1;
+    addr.sun_family = AF_UNIX;
+    path.copy(addr.sun_path, path.size());
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Sends one request; on success leaves the reader positioned after the status
+bool roundTrip(int fd, const BinaryWriter& request, std::vector<uint8_t>& frame, BinaryReader& response) {
+    if (!control::writeFrame(fd, request) || !control::readFrame(fd, frame)) {
+        std::cerr << "csopesy-ctl: connection closed" << std::endl;
+        return false;
+    }
+    response = BinaryReader(frame.data(), frame.size());
+    if (static_cast<control::Status>(response.u8()) != control::Status::Ok) {
+        std::cerr << "csopesy-ctl: " << response.str() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int printJson(int fd, const BinaryWriter& request) {
+    std::vector<uint8_t> frame;
+    BinaryReader response;
+    if (!roundTrip(fd, request, frame, response)) return 1;
+    std::cout << response.str() << std::endl;
+    return 0;
+}
+
+int submit(int fd, const std::string& name, uint64_t mem, const std::string& instructions) {
+    BinaryWriter request;
+    request.u8(static_cast<uint8_t>(control::Op::Submit));
+    request.varint(1);
+    request.str(name);
+    request.varint(mem);
+    request.str(instructions);
+
+    std::vector<uint8_t> frame;
+    BinaryReader response;
+    if (!roundTrip(fd, request, frame, response)) return 1;
+    response.varint();
+    int64_t pid = response.svarint();
+    if (pid < 0) {
+        std::cerr << "csopesy-ctl: " << response.str() << std::endl;
+        return 1;
+    }
+    std::cout << "{\"pid\":" << pid << "}" << std::endl;
+    return 0;
+}
+
+int bench(int fd, uint64_t count, uint64_t batch, uint64_t mem) {
+    const std::string prefix = "ctl-" + std::to_string(Clock::now().time_since_epoch().count() % 1000000000) + "-";
+    BinaryWriter request;
+    std::vector<uint8_t> frame;
+    BinaryReader response;
+    std::vector<double> frameMicros;
+    uint64_t accepted = 0;
+    uint64_t rejected = 0;
+
+    auto start = Clock::now();
+    for (uint64_t sent = 0; sent < count;) {
+        uint64_t n = std::min(batch, count - sent);
+        request.clear();
+        request.u8(static_cast<uint8_t>(control::Op::Submit));
+        request.varint(n);
+        for (uint64_t i = 0; i < n; ++i) {
+            request.str(prefix + std::to_string(sent + i));
+            request.varint(mem);
+            request.str({});
+        }
+
+        auto frameStart = Clock::now();
+        if (!roundTrip(fd, request, frame, response)) return 1;
+        frameMicros.push_back(std::chrono::duration<double, std::micro>(Clock::now() - frameStart).count());
+
+        uint64_t results = response.varint();
+        for (uint64_t i = 0; i < results; ++i) {
+            if (response.svarint() >= 0) {
+                accepted++;
+            } else {
+                response.str();
+                rejected++;
+            }
+        }
+        sent += n;
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::sort(frameMicros.begin(), frameMicros.end());
+    auto at = [&frameMicros](double p) {
+        return frameMicros.empty() ? 0.0 : frameMicros[static_cast<size_t>(p * (frameMicros.size() - 1) + 0.5)];
+    };
+    std::cout << std::fixed << std::setprecision(1)
+              << "{\"submitted\":" << count << ",\"accepted\":" << accepted << ",\"rejected\":" << rejected
+              << ",\"batch\":" << batch << ",\"frames\":" << frameMicros.size()
+              << ",\"seconds\":" << std::setprecision(4) << seconds
+              << ",\"per_sec\":" << std::setprecision(1) << (seconds > 0 ? count / seconds : 0.0)
+              << ",\"frame_p50_us\":" << at(0.50) << ",\"frame_p99_us\":" << at(0.99) << "}" << std::endl;
+    return rejected == 0 ? 0 : 1;
+}
+
+int usage(const char* argv0) {
+    std::cerr << "Usage: " << argv0 << " [-S <socket>] <command>\n"
+              << "  submit <name> [mem] [\"<instructions>\"]\n"
+              << "  pid <pid>\n"
+              << "  vmstat\n"
+              << "  smi [-s <column>] [-n <count>]\n"
+              << "  bench <count> [batch] [mem]" << std::endl;
+    return 2;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string path = control::defaultSocketPath;
+    int i = 1;
+    if (i + 1 < argc && std::strcmp(argv[i], "-S") == 0) {
+        path = argv[i + 1];
+        i += 2;
+    }
+    if (i >= argc) return usage(argv[0]);
+    std::string cmd = argv[i++];
+    std::vector<std::string> args(argv + i, argv + argc);
+
+    int fd = connectTo(path);
+    if (fd < 0) {
+        std::cerr << "csopesy-ctl: could not connect to " << path << std::endl;
+        return 1;
+    }
+
+    int status = 0;
+    try {
+        BinaryWriter request;
+        if (cmd == "submit" && !args.empty()) {
+            status = submit(fd, args[0], args.size() > 1 ? std::stoull(args[1]) : 0, args.size() > 2 ? args[2] : "");
+        } else if (cmd == "pid" && args.size() == 1) {
+            request.u8(static_cast<uint8_t>(control::Op::QueryPid));
+            request.svarint(std::stoll(args[0]));
+            status = printJson(fd, request);
+        } else if (cmd == "vmstat" && args.empty()) {
+            request.u8(static_cast<uint8_t>(control::Op::Vmstat));
+            status = printJson(fd, request);
+        } else if (cmd == "smi") {
+            std::string sortKey = "cpu";
+            uint64_t topN = 20;
+            for (size_t k = 0; k + 1 < args.size(); k += 2) {
+                if (args[k] == "-s") sortKey = args[k + 1];
+                else if (args[k] == "-n") topN = std::stoull(args[k + 1]);
+            }
+            request.u8(static_cast<uint8_t>(control::Op::ProcessSmi));
+            request.str(sortKey);
+            request.varint(topN);
+            status = printJson(fd, request);
+        } else if (cmd == "bench" && !args.empty()) {
+            uint64_t count = std::stoull(args[0]);
+            uint64_t batch = args.size() > 1 ? std::max<uint64_t>(1, std::stoull(args[1])) : 64;
+            uint64_t mem = args.size() > 2 ? std::stoull(args[2]) : 0;
+            status = bench(fd, count, batch, mem);
+        } else {
+            status = usage(argv[0]);
+        }
+    } catch (const std::exception&) {
+        status = usage(argv[0]);
+    }
+
+    ::close(fd);
+    return status;
+}
+
+#endif
@@ -0,0 +1,95 @@
+// Compiles screen -c style programs into a workload file for `load-workload`.
+// Built with `make wlc`.
+//
+//   csopesy-wlc <input.txt> <output.wl>
+//
+// Each non-empty input line is one program, with or without the leading
+// "screen -c"; lines starting with # are comments:
+//
+//   screen -c p1 256 "DECLARE x 5; ADD x x 1; PRINT(x)"
+//   p2 64 "WRITE 0x40 7; READ y 0x40"
+//
+// Programs are checked with the same rules as screen -c; any error aborts
+// the conversion with its line number.
+#include "../src/WorkloadFile.h"
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+namespace {
+
+bool parseLine(const std::string& line, std::string& name, int& memSize, std::string& source, std::string& error) {
+    size_t open = line.find('"');
+    size_t close = line.rfind('"');
+    if (open == std::string::npos || close == open) {
+        error = "instructions must be enclosed in quotes";
+        return false;
+    }
+
+    std::istringstream head(line.substr(0, open));
+    std::string word;
+    std::string memText;
+    head >> word;
+    if (word == "screen") {
+        std::string option;
+        head >> option >> name >> memText;
+        if (option != "-c") {
+            error = "only screen -c lines can be compiled";
+            return false;
+        }
+    } else {
+        name = word;
+        head >> memText;
+    }
+    if (name.empty() || memText.empty()) {
+        error = "expected <name> <mem-size> \"<instructions>\"";
+        return false;
+    }
+    try {
+        memSize = std::stoi(memText);
+    } catch (const std::exception&) {
+        error = "invalid memory size '" + memText + "'";
+        return false;
+    }
+    source = line.substr(open + 1, close - open - 1);
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        std::cerr << "usage: csopesy-wlc <input.txt> <output.wl>" << std::endl;
+        return 2;
+    }
+
+    std::ifstream in(argv[1]);
+    if (!in.is_open()) {
+        std::cerr << "csopesy-wlc: could not open " << argv[1] << std::endl;
+        return 1;
+    }
+
+    workloadfile::Writer writer;
+    std::string line;
+    for (int lineNo = 1; std::getline(in, line); ++lineNo) {
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#') continue;
+
+        std::string name;
+        int memSize = 0;
+        std::string source;
+        std::string error;
+        if (!parseLine(line, name, memSize, source, error) || !writer.add(name, memSize, source, error)) {
+            std::cerr << argv[1] << ":" << lineNo << ": " << error << std::endl;
+            return 1;
+        }
+    }
+
+    if (!writer.save(argv[2])) {
+        std::cerr << "csopesy-wlc: could not write " << argv[2] << std::endl;
+        return 1;
+    }
+    std::cout << "Compiled " << writer.getCount() << " programs into " << argv[2] << std::endl;
+    return 0;
+}